@@ -8,7 +8,7 @@ void polyu::run(size_t byteLength, size_t msgCount, size_t rangeProofCount, size
   polyu::run(crypto, msgCount, rangeProofCount, slotSize, msgPerBatch, fs);
 }
 
-void polyu::run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs)
+void polyu::run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs, const shared_ptr<ParamBundle> &params, const shared_ptr<VerifierKey> &key)
 {
   // extract system parameters from private keys
   auto GP_Q = crypto->getGroupQ(); // public parameter: group element Q
@@ -41,7 +41,19 @@ void polyu::run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, s
   auto decryptor = make_shared<PaillierEncryption>(pk, sk1, sk2, GP_Q, GP_P, GP_G);
   auto proverCir = make_shared<CBatchEnc>(decryptor, msgCount, rangeProofCount, slotSize, msgPerBatch);
   auto giRequired = proverCir->estimateGeneratorsRequired();
-  auto gi = decryptor->genGenerators(giRequired); // public paramters: generators gi for commitment scheme
+  Vec<ZZ_p> gi; // public paramters: generators gi for commitment scheme
+  if (params != nullptr && params->getPublicKey() == pk && params->generatorCount() >= giRequired)
+    gi = params->getGenerators(giRequired);
+  else
+    gi = decryptor->genGenerators(giRequired);
+
+  // public parameters: fixed base tables of [g, gi...], only the matching prefix is used
+  vector<FixedBase> tables;
+  if (params != nullptr && params->getPublicKey() == pk)
+  {
+    for (size_t i = 0; i < params->tableCount(); i++)
+      tables.push_back(params->getTable(i));
+  }
 
   cout << "====================" << endl;
   // P: prover prepare structured message
@@ -91,6 +103,7 @@ void polyu::run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, s
   // P: setup ZKP protocol for the circuit
   Timer::start("P.circuit");
   auto prover = proverCir->generateProver(gi);
+  prover->zkp->commitScheme->setTables(tables);
   circuitTime += Timer::end("P.circuit");
 
   // Prover need to calculate the following values to verifier
@@ -169,14 +182,27 @@ void polyu::run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, s
   auto ljir2 = verifierCir->calculateLjir();
   circuitTime += Timer::end("V.Ljir");
 
-  // V: create circuit constrains
+  // V: create circuit constrains, a matching preprocessed key is patched instead
   Timer::start("V.wireUp");
-  verifierCir->wireUp(ljir2, Lj);
+  bool preprocessed = key != nullptr && key->matches(pk, GP_Q, GP_P, GP_G, msgCount, rangeProofCount, slotSize, msgPerBatch);
+  if (!preprocessed)
+    verifierCir->wireUp(ljir2, Lj);
   circuitTime += Timer::end("V.wireUp");
 
   // V: setup ZKP protocol for the circuit
   Timer::start("V.circuit");
-  auto verifier = verifierCir->generateVerifier(gi);
+  shared_ptr<CircuitZKPVerifier> verifier;
+  if (preprocessed)
+  {
+    auto scheme = make_shared<PolynomialCommitment>(GP_Q, GP_P, GP_G, gi);
+    scheme->setTables(tables);
+    verifier = key->generateVerifier(Cm, Cm_, CRj, ljir2, Lj, scheme);
+  }
+  else
+  {
+    verifier = verifierCir->generateVerifier(gi);
+    verifier->commitScheme->setTables(tables);
+  }
   verifierCir = nullptr; // clean up, save memory
   circuitTime += Timer::end("V.circuit");
 
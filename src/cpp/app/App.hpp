@@ -17,11 +17,13 @@
 #include "./CBatchEnc.hpp"
 #include "./CircuitZKPVerifier.hpp"
 #include "./CircuitZKPProver.hpp"
+#include "./ParamBundle.hpp"
+#include "./VerifierKey.hpp"
 
 namespace polyu
 {
 
 void run(size_t byteLength, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs);
-void run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs);
+void run(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs, const shared_ptr<ParamBundle> &params = nullptr, const shared_ptr<VerifierKey> &key = nullptr);
 
 } // namespace polyu
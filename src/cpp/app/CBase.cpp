@@ -25,6 +25,7 @@ void CBase::copyCircuit(const shared_ptr<CBase> &values, const shared_ptr<CBase>
   target->linearCount = values->linearCount;
   target->gateCount = values->gateCount;
   target->offset = values->offset;
+  target->smallGates = values->smallGates;
 }
 
 CBase::CBase() {}
@@ -70,6 +71,7 @@ CBase::CBase(
 
   if (A != nullptr)
     gateCount = A->m * A->n;
+  smallGates.assign(gateCount, false);
 }
 
 void CBase::shift(size_t n)
@@ -136,7 +138,10 @@ void CBase::append(const shared_ptr<CBase> &b)
       this->C->cell(0, oldN + i, b->C->cell(0, i));
     }
   }
+  smallGates.resize(oldN, false);
+  smallGates.insert(smallGates.end(), b->smallGates.begin(), b->smallGates.end());
   gateCount += b->gateCount;
+  smallGates.resize(gateCount, false);
 
   for (size_t i = 0; i < b->linearCount; i++)
   {
@@ -189,7 +194,7 @@ size_t CBase::assignValues(const shared_ptr<CBase> &b, size_t offset)
   return ret;
 }
 
-size_t CBase::addGate(size_t n)
+size_t CBase::addGate(size_t n, bool small)
 {
   if (gateCount == 0)
   {
@@ -204,6 +209,7 @@ size_t CBase::addGate(size_t n)
     C->extend(n);
   }
   gateCount += n;
+  smallGates.resize(gateCount, small);
   return gateCount;
 }
 
@@ -216,6 +222,24 @@ size_t CBase::addLinear()
   return ++linearCount;
 }
 
+vector<size_t> CBase::layout()
+{
+  // stable partition: small gates first, then the others in emitted order
+  vector<size_t> ret(gateCount);
+  size_t pos = 0;
+  for (size_t i = 0; i < gateCount; i++)
+  {
+    if (i < smallGates.size() && smallGates[i])
+      ret[i] = pos++;
+  }
+  for (size_t i = 0; i < gateCount; i++)
+  {
+    if (i >= smallGates.size() || !smallGates[i])
+      ret[i] = pos++;
+  }
+  return ret;
+}
+
 shared_ptr<CircuitZKPVerifier> CBase::generateVerifier(const Vec<ZZ_p> &gi)
 {
   auto mnCfg = CircuitZKPVerifier::calcMN(gateCount);
@@ -231,53 +255,50 @@ shared_ptr<CircuitZKPVerifier> CBase::generateVerifier(const Vec<ZZ_p> &gi)
       m, n, linearCount);
 
   zkp->commitScheme->gi = gi;
-
-  convertWire(this->Wqa, zkp->Wqa, m, n);
-  convertWire(this->Wqb, zkp->Wqb, m, n);
-  convertWire(this->Wqc, zkp->Wqc, m, n);
+  generateWires(m, n, zkp->Wqa, zkp->Wqb, zkp->Wqc);
 
   return zkp;
 }
 
+void CBase::generateWires(size_t m, size_t n,
+                          shared_ptr<const WireMat> &Wqa,
+                          shared_ptr<const WireMat> &Wqb,
+                          shared_ptr<const WireMat> &Wqc)
+{
+  auto position = layout();
+  auto permute = [&](const vector<shared_ptr<Matrix>> &source) {
+    vector<shared_ptr<Matrix>> ret;
+    for (auto &w : source)
+      ret.push_back(w->permute(position));
+    return ret;
+  };
+  convertWire(permute(this->Wqa), Wqa, m, n);
+  convertWire(permute(this->Wqb), Wqb, m, n);
+  convertWire(permute(this->Wqc), Wqc, m, n);
+}
+
 void CBase::convertWire(const vector<shared_ptr<Matrix>> &source,
-                        map<size_t, map<size_t, map<size_t, ZZ_p>>> &target,
+                        shared_ptr<const WireMat> &target,
                         size_t m, size_t n)
 {
-  auto N = n * m;
-  for (size_t q = 0; q < source.size(); q++)
+  for (auto &w : source)
   {
-    if (source[q]->m != 1)
+    if (w->m != 1)
       throw invalid_argument("wire already converted");
-
-    if (source[q]->n > N)
-      throw invalid_argument("wire convert failed, N exceed the matrix dimension");
-
-    for (auto it : source[q]->values[0])
-    {
-      size_t i = it.first;
-      auto v = it.second;
-      size_t x = i / n;
-      size_t y = i % n;
-
-      if (IsZero(v))
-        continue;
-
-      if (target[x].find(q) == target[x].end())
-      {
-        target[x][q] = map<size_t, ZZ_p>();
-      }
-      target[x][q][y] = v;
-    }
   }
+
+  // gate k goes to row k / n, column k % n
+  target = make_shared<WireMat>(source, m, n);
 }
 
 shared_ptr<CircuitZKPProver> CBase::generateProver(const Vec<ZZ_p> &gi)
 {
   auto zkp = generateVerifier(gi);
+  auto position = layout();
   auto prover = make_shared<CircuitZKPProver>(zkp,
-                                              A->group(zkp->n, zkp->m),
-                                              B->group(zkp->n, zkp->m),
-                                              C->group(zkp->n, zkp->m));
+                                              A->permute(position)->group(zkp->n, zkp->m),
+                                              B->permute(position)->group(zkp->n, zkp->m),
+                                              C->permute(position)->group(zkp->n, zkp->m));
   return prover;
 }
 
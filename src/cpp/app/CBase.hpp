@@ -21,7 +21,7 @@ class CBase
 {
 private:
   void convertWire(const vector<shared_ptr<Matrix>> &source,
-                   map<size_t, map<size_t, map<size_t, ZZ_p>>> &target,
+                   shared_ptr<const WireMat> &target,
                    size_t m, size_t n);
 
 public:
@@ -72,6 +72,9 @@ public:
   /// @brief  Constrains offset, for append circuit
   size_t offset = 0;
 
+  /// @brief  Public hints of gates which only carry small values (eg. bits), used by layout()
+  vector<bool> smallGates;
+
   /**
    * @brief Construct a new CBase object
    */
@@ -131,11 +134,32 @@ public:
   size_t assignValues(const shared_ptr<CBase> &b, size_t offset = 0);
 
   /// @private
-  size_t addGate(size_t n = 1);
+  size_t addGate(size_t n = 1, bool small = false);
 
   /// @private
   size_t addLinear();
 
+  /**
+   * @brief Gate layout before grouping, gates with the small value hint are placed first so each row of the grouped matrices is uniform in value size. It only depends on the public hints, so prover and verifier derive the same layout
+   *
+   * @return vector<size_t> New position of each gate
+   */
+  vector<size_t> layout();
+
+  /**
+   * @brief Convert the linear constrains to sparse rows of the grouped m x n matrices, in the gate layout of layout()
+   *
+   * @param m Matrix size m
+   * @param n Matrix size n
+   * @param Wqa Result w_q,a
+   * @param Wqb Result w_q,b
+   * @param Wqc Result w_q,c
+   */
+  void generateWires(size_t m, size_t n,
+                     shared_ptr<const WireMat> &Wqa,
+                     shared_ptr<const WireMat> &Wqb,
+                     shared_ptr<const WireMat> &Wqc);
+
   /**
    * @brief Generate CircuitZKPVerifier object
    *
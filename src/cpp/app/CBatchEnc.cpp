@@ -59,21 +59,12 @@ void CBatchEnc::encrypt(const Vec<ZZ> &msg)
 
   m = msg;
 
-  for (size_t i = 0; i < msgCount; i++)
-  {
-    auto r = crypto->pickRandom();
-    auto c = crypto->encrypt(m[i], r);
-    Rm.append(r);
-    Cm.append(c);
-  }
+  Vec<ZZ> rjs;
   for (size_t i = 0; i < rangeProofCount; i++)
   {
     auto rj = MathUtils::randZZ_p(RjMax);
-    auto r = crypto->pickRandom();
-    auto c = crypto->encrypt(conv<ZZ>(rj), r);
     Rj.append(rj);
-    RRj.append(r);
-    CRj.append(c);
+    rjs.append(conv<ZZ>(rj));
   }
   for (size_t i = 0; i < batchCount; i++)
   {
@@ -96,12 +87,12 @@ void CBatchEnc::encrypt(const Vec<ZZ> &msg)
       m_iStr = miStr + m_iStr;
     }
     auto m_i = ConvertUtils::binaryStringToZZ(m_iStr);
-    auto r = crypto->pickRandom();
-    auto c = crypto->encrypt(m_i, r);
     m_.append(m_i);
-    Rm_.append(r);
-    Cm_.append(c);
   }
+
+  crypto->encryptBatch(m, Cm, Rm);
+  crypto->encryptBatch(rjs, CRj, RRj);
+  crypto->encryptBatch(m_, Cm_, Rm_);
 }
 
 void CBatchEnc::setCipher(const Vec<ZZ_p> &Cm,
@@ -123,7 +114,11 @@ size_t CBatchEnc::getLjLength()
 
 binary_t CBatchEnc::calculateLjir()
 {
-  size_t len = getLjLength();
+  return calculateLjir(Cm, Cm_, CRj, getLjLength());
+}
+
+binary_t CBatchEnc::calculateLjir(const Vec<ZZ_p> &Cm, const Vec<ZZ_p> &Cm_, const Vec<ZZ_p> &CRj, size_t len)
+{
   binary_t seed;
   for (auto v : Cm)
     ConvertUtils::append(seed, ConvertUtils::toBinary(v));
@@ -132,9 +127,11 @@ binary_t CBatchEnc::calculateLjir()
   for (auto v : CRj)
     ConvertUtils::append(seed, ConvertUtils::toBinary(v));
 
+  RandomStreamPush push;
   SetSeed(seed.data(), seed.size());
-  auto Ljir = RandomBits_ZZ(len * 8);
-  return ConvertUtils::toBinary(Ljir);
+  auto Ljir = ConvertUtils::toBinary(RandomBits_ZZ(len * 8));
+  ConvertUtils::fixBinary(Ljir, len); // keep the high zero bytes
+  return Ljir;
 }
 
 Vec<ZZ_p> CBatchEnc::calculateLj(const binary_t &Ljir)
@@ -197,6 +194,7 @@ void CBatchEnc::wireUp(const binary_t &Ljir, const Vec<ZZ_p> &Lj)
     auto c = this->Cm[i];
     cir->updateCipher(c);
     this->append(cir);
+    cipherLinears.push_back(linearCount - 1);
   }
 
   // Const{c'j, R'j, r'j} x j
@@ -207,6 +205,7 @@ void CBatchEnc::wireUp(const binary_t &Ljir, const Vec<ZZ_p> &Lj)
     auto c = this->CRj[i];
     cir->updateCipher(c);
     this->append(cir);
+    cipherLinears.push_back(linearCount - 1);
   }
 
   // Const{c*s, m*s, r*s} x s
@@ -217,6 +216,7 @@ void CBatchEnc::wireUp(const binary_t &Ljir, const Vec<ZZ_p> &Lj)
     auto c = this->Cm_[i];
     cir->updateCipher(c);
     this->append(cir);
+    cipherLinears.push_back(linearCount - 1);
   }
 
   size_t n, q;
@@ -225,13 +225,13 @@ void CBatchEnc::wireUp(const binary_t &Ljir, const Vec<ZZ_p> &Lj)
   auto NEG_ONE = conv<ZZ_p>(-1);
 
   // bri * (bri - 1) = 0
-  size_t briOffset = gateCount;
+  briOffset = gateCount;
   for (size_t i = 0; i < msgCount; i++)
   {
     for (size_t r = 0; r < slotsPerMsg; r++)
     {
       // gate: bri * (bri - 1) = 0
-      n = addGate();
+      n = addGate(1, true);
 
       // linear: ai - bi = 1;
       q = addLinear();
@@ -270,6 +270,7 @@ void CBatchEnc::wireUp(const binary_t &Ljir, const Vec<ZZ_p> &Lj)
   for (size_t j = 0; j < rangeProofCount; j++)
   {
     q = addLinear();
+    rangeLinears.push_back(q - 1);
 
     // R'j
     Wqa[q - 1]->cell(0, encRjOffset + encCirN * j, ONE);
@@ -74,6 +74,15 @@ public:
   /// @brief Ciphertexts of range proof masks
   Vec<ZZ_p> CRj;
 
+  /// @brief Linear constrains (0-based) whose K_q is a ciphertext, in order of Cm, CRj, Cm_; set by wireUp()
+  vector<size_t> cipherLinears;
+
+  /// @brief Linear constrains (0-based) of the range proofs, whose K_q is L_j; set by wireUp()
+  vector<size_t> rangeLinears;
+
+  /// @brief First gate of the bits b_i,r, gate of b_i,r is (briOffset + i * slotsPerMsg + r); set by wireUp()
+  size_t briOffset = 0;
+
   using CBase::CBase;
 
   /**
@@ -135,6 +144,17 @@ public:
    */
   binary_t calculateLjir();
 
+  /**
+   * @brief Calculate the challenge value (L_j,i,r) base on the ciphertext, used for non-interactive mode. The seeding is scoped, the random stream of the calling thread is restored afterwards
+   *
+   * @param Cm Ciphertexts of messages
+   * @param Cm_ Ciphertexts of auxiliary messages
+   * @param CRj Ciphertexts of range proof masks
+   * @param len Length of L_j,i,r (in byte)
+   * @return binary_t
+   */
+  static binary_t calculateLjir(const Vec<ZZ_p> &Cm, const Vec<ZZ_p> &Cm_, const Vec<ZZ_p> &CRj, size_t len);
+
   /**
    * @brief Calculate challenge response (L_j = l * b + R_j) for range proof
    *
@@ -0,0 +1,101 @@
+#include "./ChallengePowers.hpp"
+
+ChallengePowers::ChallengePowers(const ZZ &p, size_t m, size_t n, size_t Q, const ZZ_p &y)
+{
+  ZZ_pPush push(p);
+  if (IsZero(y))
+    throw invalid_argument("challenge value must be non-zero");
+
+  this->y = y;
+  init(p, m, n, Q, inv(y));
+}
+
+ChallengePowers::ChallengePowers(const ZZ &p, size_t m, size_t n, size_t Q, const ZZ_p &y, const ZZ_p &x)
+{
+  ZZ_pPush push(p);
+  if (IsZero(y) || IsZero(x))
+    throw invalid_argument("challenge value must be non-zero");
+
+  // one inversion: (xy)^-1, y^-1 = x * (xy)^-1, x^-1 = y * (xy)^-1
+  ZZ_p invXY = inv(x * y);
+  this->y = y;
+  this->x = x;
+  withX = true;
+  init(p, m, n, Q, invXY * x);
+
+  MathUtils::powerVecZZ_p(x, 2 * m + 2, p, Xi);
+  MathUtils::powerVecZZ_p(invXY * y, 2 * m + 1, p, invXi);
+}
+
+void ChallengePowers::init(const ZZ &p, size_t m, size_t n, size_t Q, const ZZ_p &invY)
+{
+  ZZ_pPush push(p);
+
+  MathUtils::powerVecZZ_p(y, m + 1, p, Yi);
+  MathUtils::powerVecZZ_p(invY, m + 1, p, invYi);
+
+  // Y' = [y^m, y^2m, ... , y^mn]
+  Y_.SetLength(n);
+  if (n > 0)
+    Y_[0] = Yi[m];
+  for (size_t i = 1; i < n; i++)
+    mul(Y_[i], Y_[i - 1], Yi[m]);
+
+  // y^(M+q), M = mn + m
+  YMq.SetLength(Q);
+  if (Q > 0)
+    mul(YMq[0], n > 0 ? Y_[n - 1] * Yi[m] : Yi[m], y);
+  for (size_t q = 1; q < Q; q++)
+    mul(YMq[q], YMq[q - 1], y);
+}
+
+const ZZ_p &ChallengePowers::getY() const
+{
+  return y;
+}
+
+const ZZ_p &ChallengePowers::getX() const
+{
+  if (!withX)
+    throw invalid_argument("challenge value x is not set");
+  return x;
+}
+
+bool ChallengePowers::hasX() const
+{
+  return withX;
+}
+
+const Vec<ZZ_p> &ChallengePowers::getYi() const
+{
+  return Yi;
+}
+
+const Vec<ZZ_p> &ChallengePowers::getInvYi() const
+{
+  return invYi;
+}
+
+const Vec<ZZ_p> &ChallengePowers::getY_() const
+{
+  return Y_;
+}
+
+const Vec<ZZ_p> &ChallengePowers::getYMq() const
+{
+  return YMq;
+}
+
+const Vec<ZZ_p> &ChallengePowers::getXi() const
+{
+  if (!withX)
+    throw invalid_argument("challenge value x is not set");
+  return Xi;
+}
+
+const Vec<ZZ_p> &ChallengePowers::getInvXi() const
+{
+  if (!withX)
+    throw invalid_argument("challenge value x is not set");
+  return invXi;
+}
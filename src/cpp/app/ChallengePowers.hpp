@@ -0,0 +1,103 @@
+#pragma once
+
+#include "./namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+
+#include "./math/MathUtils.hpp"
+
+namespace polyu
+{
+
+/**
+ * @brief _ChallengePowers_ holds the powers of the challenge values (y, x) used by the circuit ZKP, under modulus p. It is computed once per challenge with a single inversion and never changes afterwards, so one object can be shared by concurrent readers.
+ */
+class ChallengePowers
+{
+private:
+  ZZ_p y;
+  ZZ_p x;
+  bool withX = false;
+
+  Vec<ZZ_p> Yi;    // [1, y, y^2, ... , y^m]
+  Vec<ZZ_p> invYi; // [1, y^-1, y^-2, ... , y^-m]
+  Vec<ZZ_p> Y_;    // [y^m, y^2m, ... , y^mn]
+  Vec<ZZ_p> YMq;   // [y^(M+1), y^(M+2), ... , y^(M+Q)]
+  Vec<ZZ_p> Xi;    // [1, x, x^2, ... , x^(2m+1)]
+  Vec<ZZ_p> invXi; // [1, x^-1, x^-2, ... , x^-2m]
+
+  void init(const ZZ &p, size_t m, size_t n, size_t Q, const ZZ_p &invY);
+
+public:
+  /**
+   * @brief Construct the powers of challenge value (y), used before (x) is known
+   *
+   * @param p Group element p
+   * @param m Matrix size m
+   * @param n Matrix size n
+   * @param Q Circuit's linear constrains count
+   * @param y Challenge value (y)
+   */
+  ChallengePowers(const ZZ &p, size_t m, size_t n, size_t Q, const ZZ_p &y);
+
+  /**
+   * @brief Construct the powers of challenge values (y, x)
+   *
+   * @param p Group element p
+   * @param m Matrix size m
+   * @param n Matrix size n
+   * @param Q Circuit's linear constrains count
+   * @param y Challenge value (y)
+   * @param x Challenge value (x)
+   */
+  ChallengePowers(const ZZ &p, size_t m, size_t n, size_t Q, const ZZ_p &y, const ZZ_p &x);
+
+  /**
+   * @brief Challenge value (y)
+   */
+  const ZZ_p &getY() const;
+
+  /**
+   * @brief Challenge value (x), throws if it is not set
+   */
+  const ZZ_p &getX() const;
+
+  /**
+   * @brief Whether challenge value (x) is set
+   */
+  bool hasX() const;
+
+  /**
+   * @brief [1, y, y^2, ... , y^m]
+   */
+  const Vec<ZZ_p> &getYi() const;
+
+  /**
+   * @brief [1, y^-1, y^-2, ... , y^-m]
+   */
+  const Vec<ZZ_p> &getInvYi() const;
+
+  /**
+   * @brief [y^m, y^2m, ... , y^mn]
+   */
+  const Vec<ZZ_p> &getY_() const;
+
+  /**
+   * @brief [y^(M+1), y^(M+2), ... , y^(M+Q)], indexed by q - 1
+   */
+  const Vec<ZZ_p> &getYMq() const;
+
+  /**
+   * @brief [1, x, x^2, ... , x^(2m+1)], x^(m+i) is at index m + i. Throws if (x) is not set
+   */
+  const Vec<ZZ_p> &getXi() const;
+
+  /**
+   * @brief [1, x^-1, x^-2, ... , x^-2m], x^-(m+i) is at index m + i. Throws if (x) is not set
+   */
+  const Vec<ZZ_p> &getInvXi() const;
+};
+
+} // namespace polyu
@@ -9,9 +9,9 @@ CircuitZKPProver::CircuitZKPProver(
   ZZ_pPush push(zkp->GP_P);
 
   this->zkp = zkp;
-  A->toMat(this->A);
-  B->toMat(this->B);
-  C->toMat(this->C);
+  this->A = CompactMat(*A, zkp->GP_P);
+  this->B = CompactMat(*B, zkp->GP_P);
+  this->C = CompactMat(*C, zkp->GP_P);
 
   if (this->A.NumRows() != zkp->m || this->A.NumCols() != zkp->n ||
       this->B.NumRows() != zkp->m || this->B.NumCols() != zkp->n ||
@@ -28,9 +28,9 @@ CircuitZKPProver::CircuitZKPProver(
   ZZ_pPush push(zkp->GP_P);
 
   this->zkp = zkp;
-  this->A = A;
-  this->B = B;
-  this->C = C;
+  this->A = CompactMat(A, zkp->GP_P);
+  this->B = CompactMat(B, zkp->GP_P);
+  this->C = CompactMat(C, zkp->GP_P);
 
   if (this->A.NumRows() != zkp->m || this->A.NumCols() != zkp->n ||
       this->B.NumRows() != zkp->m || this->B.NumCols() != zkp->n ||
@@ -40,34 +40,41 @@ CircuitZKPProver::CircuitZKPProver(
 
 void CircuitZKPProver::commit(Vec<ZZ_p> &ret)
 {
-  MathUtils::randVecZZ_p(zkp->m, zkp->GP_P, randA);
-  MathUtils::randVecZZ_p(zkp->m, zkp->GP_P, randB);
-  MathUtils::randVecZZ_p(zkp->m, zkp->GP_P, randC);
+  auto &scheme = zkp->commitScheme;
+
+  // blinding g^r is taken from the pool of the commitment scheme if attached
+  Vec<ZZ_p> grA, grB, grC;
+  ZZ_p grD;
+  scheme->pickBlinding(zkp->m, randA, grA);
+  scheme->pickBlinding(zkp->m, randB, grB);
+  scheme->pickBlinding(zkp->m, randC, grC);
+  scheme->pickBlinding(randD, grD);
   MathUtils::randVecZZ_p(zkp->n, zkp->GP_P, D);
-  randD = MathUtils::randZZ_p(zkp->GP_P);
 
   ret.SetLength(0);
   Vec<ZZ_p> tmp;
-  zkp->commitScheme->commit(A, randA, tmp);
+  scheme->commitBlinded(A, grA, tmp);
   ret.append(tmp);
-  zkp->commitScheme->commit(B, randB, tmp);
+  scheme->commitBlinded(B, grB, tmp);
   ret.append(tmp);
-  zkp->commitScheme->commit(C, randC, tmp);
+  scheme->commitBlinded(C, grC, tmp);
   ret.append(tmp);
-  ret.append(zkp->commitScheme->commit(D, randD));
+  ret.append(scheme->commitBlinded(D, grD, scheme->threads));
 }
 
 void CircuitZKPProver::polyCommit(const ZZ_p &y, Vec<ZZ_p> &ret)
+{
+  polyCommit(zkp->challengePowers(y), ret);
+}
+
+void CircuitZKPProver::polyCommit(const ChallengePowers &cp, Vec<ZZ_p> &ret)
 {
   Timer::start("prover.polyCommit");
   const size_t m = zkp->m;
   const size_t n = zkp->n;
 
-  Timer::start("prover.setY");
-  zkp->setY(y);            // recalculate cachedY_ and cachedY_Mq
-  auto Y = zkp->getY(y);   // [1, y, y^2, ... , y^m]
-  auto Y_ = zkp->getY_(y); // [y^m, y^2m, ... , y^mn]
-  Timer::end("prover.setY");
+  auto &Y = cp.getYi();  // [1, y, y^2, ... , y^m]
+  auto &Y_ = cp.getY_(); // [y^m, y^2m, ... , y^mn]
 
   ZZ_pPush push(zkp->GP_P);
   vector<ZZ_pX> rx;
@@ -92,12 +99,12 @@ void CircuitZKPProver::polyCommit(const ZZ_p &y, Vec<ZZ_p> &ret)
   {
     for (size_t j = 1; j <= n; j++)
     {
-      mul(tmp, A(i, j), Y[i]);
+      mul(tmp, A.get(i - 1, j - 1), Y[i]);
       SetCoeff(rx[j - 1], m + i, tmp);
 
-      SetCoeff(rx[j - 1], m - i, B(i, j));
+      SetCoeff(rx[j - 1], m - i, B.get(i - 1, j - 1));
 
-      SetCoeff(rx[j - 1], m2 + i, C(i, j));
+      SetCoeff(rx[j - 1], m2 + i, C.get(i - 1, j - 1));
     }
   }
   for (size_t j = 1; j <= n; j++)
@@ -112,7 +119,7 @@ void CircuitZKPProver::polyCommit(const ZZ_p &y, Vec<ZZ_p> &ret)
   // s(X) = SUM(Wai(y) * y^-i * X^-i) + SUM(Wbi(y) * X^i) + X^-m * SUM(Wci(y) * X^-i)
   //      = (X^2m) * ( SUM(Wai(y) * y^-i * X^(2m-i)) + SUM(Wbi(y) * X^(2m+i)) + SUM(Wci(y) * X^(m-i)) )
   Timer::start("prover.sx");
-  zkp->createSx(y, sx);
+  zkp->createSx(cp, sx);
   Timer::end("prover.sx");
 
   // r_(X) = r(X) inner Y_ + 2 * s(X)
@@ -137,7 +144,7 @@ void CircuitZKPProver::polyCommit(const ZZ_p &y, Vec<ZZ_p> &ret)
   // t(X) = r(X) * r_(X) - 2K(y)
   //      = X^(-3m) * ( r(X) * r_(X) - 2K(y) * X^3m )
   Timer::start("prover.ky");
-  auto ky = zkp->K(y);
+  auto ky = zkp->K(cp);
   ZZ_pX kyX;
   SetCoeff(kyX, m3, ky * 2);
   Timer::end("prover.ky");
@@ -166,7 +173,8 @@ void CircuitZKPProver::polyCommit(const ZZ_p &y, Vec<ZZ_p> &ret)
   }
   zkp->commitScheme->calcT(zkp->txM1, zkp->txM2, zkp->txN, tx, txT);
 
-  MathUtils::randVecZZ_p(zkp->txM1 + zkp->txM2 + 1, zkp->GP_P, txRi);
+  // the randomness is picked with the commitment
+  txRi.SetLength(0);
   Timer::end("prover.txT");
 
   Timer::start("prover.txCommit");
@@ -178,6 +186,11 @@ void CircuitZKPProver::polyCommit(const ZZ_p &y, Vec<ZZ_p> &ret)
 }
 
 void CircuitZKPProver::prove(const ZZ_p &y, const ZZ_p &x, Vec<ZZ_p> &ret)
+{
+  prove(zkp->challengePowers(y, x), ret);
+}
+
+void CircuitZKPProver::prove(const ChallengePowers &cp, Vec<ZZ_p> &ret)
 {
   const auto m = zkp->m;
   const auto n = zkp->n;
@@ -189,44 +202,45 @@ void CircuitZKPProver::prove(const ZZ_p &y, const ZZ_p &x, Vec<ZZ_p> &ret)
   // Mat<ZZ_p> txT;
   // zkp->commitScheme->calcT(zkp->txM1, zkp->txM2, zkp->txN, tx, txT);
   // txTMat->toMat(txT);
-  zkp->commitScheme->eval(zkp->txM1, zkp->txM2, zkp->txN, txT, txRi, x, ret);
+  zkp->commitScheme->eval(zkp->txM1, zkp->txM2, zkp->txN, txT, txRi, cp.getX(), ret);
 
   // r =   SUM(ai * x^i * y^i) +  SUM(bi * x^-i) + x^m *  SUM(ci * x^i) + d * x^(2m+1)
   // rr = SUM(rai * x^i * y^i) + SUM(rbi * x^-i) + x^m * SUM(rci * x^i) + d * x^(2m+1)
-  ZZ_p xi = conv<ZZ_p>(1);
-  ZZ_p yi = conv<ZZ_p>(1);
-  ZZ_p xmi = power(x, m);
-  ZZ_p xi_;
+  auto &Xi = cp.getXi();
+  auto &invXi = cp.getInvXi();
+  auto &Yi = cp.getYi();
 
   Vec<ZZ_p> r;
   r.SetLength(n);
   ZZ_p rr;
   ZZ_p tmp;
+  ZZ_p xyi;
   Vec<ZZ_p> tmpVec;
+  Vec<ZZ_p> row;
 
   for (int i = 1; i <= m; i++)
   {
-    mul(xi, xi, x);   // x^1, x^2, ... x^m
-    mul(yi, yi, y);   // y^1, y^2, ... y^m
-    mul(xmi, xmi, x); // x^m+1, x^m+2, ..., x^2m
-    inv(xi_, xi);     // x^-1, x^-2, ... x^-m
+    auto &xi_ = invXi[i];   // x^-1, x^-2, ... x^-m
+    auto &xmi = Xi[m + i];  // x^m+1, x^m+2, ..., x^2m
+    mul(xyi, Xi[i], Yi[i]); // x^i * y^i
 
     // ai * x^i * y^i
-    mul(tmpVec, A(i), xi);
-    mul(tmpVec, tmpVec, yi);
+    A.row(i - 1, row);
+    mul(tmpVec, row, xyi);
     add(r, r, tmpVec);
 
     // bi * x^-i
-    mul(tmpVec, B(i), xi_);
+    B.row(i - 1, row);
+    mul(tmpVec, row, xi_);
     add(r, r, tmpVec);
 
     // ci * x^m+i
-    mul(tmpVec, C(i), xmi);
+    C.row(i - 1, row);
+    mul(tmpVec, row, xmi);
     add(r, r, tmpVec);
 
     // randAi * x^i * y^i
-    mul(tmp, randA(i), xi);
-    mul(tmp, tmp, yi);
+    mul(tmp, randA(i), xyi);
     add(rr, rr, tmp);
 
     // randBi * x^-i
@@ -239,12 +253,12 @@ void CircuitZKPProver::prove(const ZZ_p &y, const ZZ_p &x, Vec<ZZ_p> &ret)
   }
 
   // D * x^2m+1
-  mul(xmi, xmi, x); // x^2m+1
-  mul(tmpVec, D, xmi);
+  auto &x2m1 = Xi[2 * m + 1];
+  mul(tmpVec, D, x2m1);
   add(r, r, tmpVec);
 
   // randD * x^2m+1
-  mul(tmp, randD, xmi);
+  mul(tmp, randD, x2m1);
   add(rr, rr, tmp);
 
   ret.append(r);
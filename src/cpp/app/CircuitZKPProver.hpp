@@ -13,6 +13,7 @@
 #include "./math/MathUtils.hpp"
 #include "./utils/ConvertUtils.hpp"
 #include "./math/Matrix.hpp"
+#include "./math/CompactMat.hpp"
 #include "./utils/Timer.hpp"
 
 namespace polyu
@@ -28,14 +29,14 @@ public:
   /// @brief Common ZKP functions
   shared_ptr<CircuitZKPVerifier> zkp;
 
-  /// @brief Circuit arguments' value assignment A
-  Mat<ZZ_p> A;
+  /// @brief Circuit arguments' value assignment A, small values are stored inline
+  CompactMat A;
 
-  /// @brief Circuit arguments' value assignment B
-  Mat<ZZ_p> B;
+  /// @brief Circuit arguments' value assignment B, small values are stored inline
+  CompactMat B;
 
-  /// @brief Circuit arguments' value assignment C
-  Mat<ZZ_p> C;
+  /// @brief Circuit arguments' value assignment C, small values are stored inline
+  CompactMat C;
 
   /// @brief Randomness vector D
   Vec<ZZ_p> D;
@@ -101,6 +102,14 @@ public:
    */
   void polyCommit(const ZZ_p &y, Vec<ZZ_p> &result);
 
+  /**
+   * @brief Polynomial commitments for t(x)
+   *
+   * @param cp Powers of challenge value (y)
+   * @param result Polynomial commitments result (pc)
+   */
+  void polyCommit(const ChallengePowers &cp, Vec<ZZ_p> &result);
+
   /**
    * @brief Prove circuit
    *
@@ -109,6 +118,14 @@ public:
    * @param result Proofs
    */
   void prove(const ZZ_p &y, const ZZ_p &x, Vec<ZZ_p> &result);
+
+  /**
+   * @brief Prove circuit
+   *
+   * @param cp Powers of challenge values (y, x)
+   * @param result Proofs
+   */
+  void prove(const ChallengePowers &cp, Vec<ZZ_p> &result);
 };
 
 } // namespace polyu
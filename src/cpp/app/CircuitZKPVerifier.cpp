@@ -1,5 +1,8 @@
 #include "./CircuitZKPVerifier.hpp"
 
+#include <random>
+#include <mutex>
+
 vector<size_t> CircuitZKPVerifier::calcMN(size_t _N)
 {
   double N = _N;
@@ -59,244 +62,136 @@ CircuitZKPVerifier::CircuitZKPVerifier(
   // FIXME: DEV_ONLY: DEPRECATED: we should have explicit independent generators gi
   this->commitScheme = make_shared<PolynomialCommitment>(this->GP_Q, this->GP_P, this->GP_G, max(this->txN, this->n));
 
-  convertWire(Wqa, this->Wqa);
-  convertWire(Wqb, this->Wqb);
-  convertWire(Wqc, this->Wqc);
+  this->Wqa = make_shared<WireMat>(Wqa, m, n);
+  this->Wqb = make_shared<WireMat>(Wqb, m, n);
+  this->Wqc = make_shared<WireMat>(Wqc, m, n);
   this->Kq = Kq;
 }
-void CircuitZKPVerifier::convertWire(const vector<shared_ptr<Matrix>> &source, map<size_t, map<size_t, map<size_t, ZZ_p>>> &target)
-{
-  for (size_t i = 0; i < m; i++)
-  {
-    target[i] = map<size_t, map<size_t, ZZ_p>>();
-
-    for (size_t q = 0; q < source.size(); q++)
-    {
-      if (source[q]->rowExists(i))
-      {
-        for (auto it : source[q]->values[i])
-        {
-          size_t j = it.first;
-          auto v = it.second;
-
-          if (IsZero(v))
-            continue;
-
-          if (target[i].find(q) == target[i].end())
-          {
-            target[i][q] = map<size_t, ZZ_p>();
-          }
-          target[i][q][j] = v;
-        }
-      }
-    }
-  }
-}
 
-Vec<ZZ_p> &CircuitZKPVerifier::getY_Mq(const ZZ_p &y)
+CircuitZKPVerifier::CircuitZKPVerifier(
+    const ZZ &GP_Q,
+    const ZZ &GP_P,
+    const ZZ_p &GP_G,
+    const shared_ptr<const WireMat> &Wqa,
+    const shared_ptr<const WireMat> &Wqb,
+    const shared_ptr<const WireMat> &Wqc,
+    const Vec<ZZ_p> &Kq,
+    const shared_ptr<PolynomialCommitment> &commitScheme)
 {
-  if (!IsZero(cachedY_Mq))
-    return cachedY_Mq;
-
-  ZZ_pPush push(GP_P);
-  cachedY_Mq.SetLength(Q);
+  if (Wqb->NumRows() != Wqa->NumRows() || Wqc->NumRows() != Wqa->NumRows() ||
+      Wqb->NumCols() != Wqa->NumCols() || Wqc->NumCols() != Wqa->NumCols())
+    throw invalid_argument("linear constrains dimension mismatch");
 
-  ZZ_p y_M = power(y, this->M); // y^M
-  mul(cachedY_Mq[0], y_M, y);   // y^(M+1)
-  for (size_t q = 1; q < Q; q++)
-  {
-    mul(cachedY_Mq[q], cachedY_Mq[q - 1], y); // y^(M+q)
-  }
-  return cachedY_Mq;
-}
+  this->GP_Q = GP_Q;
+  this->GP_P = GP_P;
+  this->GP_G = GP_G;
 
-ZZ_p CircuitZKPVerifier::getY_Mq(const ZZ_p &y, size_t q)
-{
-  return getY_Mq(y)[q - 1];
-}
+  this->Q = Kq.length();
+  this->m = Wqa->NumRows();
+  this->n = Wqa->NumCols();
+  this->N = m * n;
+  this->M = N + m;
 
-Vec<ZZ_p> &CircuitZKPVerifier::getY(const ZZ_p &y)
-{
-  if (!IsZero(cachedY))
-    return cachedY;
+  auto txCfg = CircuitZKPVerifier::calcM1M2N(m);
+  this->txM1 = txCfg[0];
+  this->txM2 = txCfg[1];
+  this->txN = txCfg[2];
 
-  MathUtils::powerVecZZ_p(y, m + 1, GP_P, cachedY); // [1, y, y^2, ... , y^m]
-  return cachedY;
+  this->commitScheme = commitScheme;
+  this->Wqa = Wqa;
+  this->Wqb = Wqb;
+  this->Wqc = Wqc;
+  this->Kq = Kq;
 }
 
-Vec<ZZ_p> &CircuitZKPVerifier::getY_(const ZZ_p &y)
+ChallengePowers CircuitZKPVerifier::challengePowers(const ZZ_p &y) const
 {
-  if (!IsZero(cachedY_))
-    return cachedY_;
-
-  ZZ_pPush push(GP_P);
-  cachedY_.SetLength(n);
-
-  power(cachedY_[0], y, m); // y^m
-  for (size_t i = 1; i < n; i++)
-  {
-    // y^m * previous object (so [y^m, y^2m, ... , y^mn])
-    mul(cachedY_[i], cachedY_[i - 1], cachedY_[0]);
-  }
-  return cachedY_;
+  return ChallengePowers(GP_P, m, n, Q, y);
 }
 
-void CircuitZKPVerifier::setY(const ZZ_p &y)
+ChallengePowers CircuitZKPVerifier::challengePowers(const ZZ_p &y, const ZZ_p &x) const
 {
-  this->cachedY_Mq.SetLength(0);
-  this->cachedY.SetLength(0);
-  this->cachedY_.SetLength(0);
-  getY_Mq(y);
-  getY(y);
-  getY_(y);
+  return ChallengePowers(GP_P, m, n, Q, y, x);
 }
 
-shared_ptr<Matrix> CircuitZKPVerifier::Wai(size_t i, const ZZ_p &y)
+void CircuitZKPVerifier::wireRow(const WireMat &W, size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const
 {
   if (i <= 0 || i > m)
     throw invalid_argument("i should between 1 to m");
 
+  auto &Y_Mq = cp.getYMq();
   ZZ_p tmp;
-
-  auto ret = make_shared<Matrix>(1, n);
-  for (auto it1 : Wqa[i - 1])
+  for (auto &e : W.row(i - 1))
   {
-    size_t q = it1.first + 1;
-    auto Wqi = it1.second;
-
-    auto yMq = getY_Mq(y, q);
-    for (auto it2 : Wqi)
+    if (IsOne(e.v))
     {
-      size_t j = it2.first;
-      auto v = it2.second;
-
-      if (IsOne(v))
-      {
-        tmp = yMq;
-      }
-      else
-      {
-        mul(tmp, v, yMq);
-      }
-      if (ret->cellExists(0, j))
-      {
-        add(tmp, tmp, ret->cell(0, j));
-      }
-      ret->cell(0, j, tmp);
+      add(ret[e.j], ret[e.j], Y_Mq[e.q]);
+    }
+    else
+    {
+      mul(tmp, e.v, Y_Mq[e.q]);
+      add(ret[e.j], ret[e.j], tmp);
     }
   }
-  return ret;
 }
 
-shared_ptr<Matrix> CircuitZKPVerifier::Wbi(size_t i, const ZZ_p &y)
+void CircuitZKPVerifier::Wai(size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const
 {
-  if (i <= 0 || i > m)
-    throw invalid_argument("i should between 1 to m");
-
-  ZZ_p tmp;
-
-  auto ret = make_shared<Matrix>(1, n);
-  for (auto it1 : Wqb[i - 1])
-  {
-    size_t q = it1.first + 1;
-    auto Wqi = it1.second;
-
-    auto yMq = getY_Mq(y, q);
-    for (auto it2 : Wqi)
-    {
-      size_t j = it2.first;
-      auto v = it2.second;
+  ret.SetLength(n);
+  clear(ret);
+  wireRow(*Wqa, i, cp, ret);
+  if (WqaPatch != nullptr)
+    wireRow(*WqaPatch, i, cp, ret);
+}
 
-      if (IsOne(v))
-      {
-        tmp = yMq;
-      }
-      else
-      {
-        mul(tmp, v, yMq);
-      }
-      if (ret->cellExists(0, j))
-      {
-        add(tmp, tmp, ret->cell(0, j));
-      }
-      ret->cell(0, j, tmp);
-    }
-  }
-  return ret;
+void CircuitZKPVerifier::Wbi(size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const
+{
+  ret.SetLength(n);
+  clear(ret);
+  wireRow(*Wqb, i, cp, ret);
 }
 
-shared_ptr<Matrix> CircuitZKPVerifier::Wci(size_t i, const ZZ_p &y)
+void CircuitZKPVerifier::Wci(size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const
 {
-  if (i <= 0 || i > m)
-    throw invalid_argument("i should between 1 to m");
+  ret.SetLength(n);
+  clear(ret);
+  wireRow(*Wqc, i, cp, ret);
 
   ZZ_p tmp;
-
-  auto ret = make_shared<Matrix>(1, n);
-  for (auto it1 : Wqc[i - 1])
-  {
-    size_t q = it1.first + 1;
-    auto Wqi = it1.second;
-
-    auto yMq = getY_Mq(y, q);
-    for (auto it2 : Wqi)
-    {
-      size_t j = it2.first;
-      auto v = it2.second;
-
-      if (IsOne(v))
-      {
-        tmp = yMq;
-      }
-      else
-      {
-        mul(tmp, v, yMq);
-      }
-      if (ret->cellExists(0, j))
-      {
-        add(tmp, tmp, ret->cell(0, j));
-      }
-      ret->cell(0, j, tmp);
-    }
-  }
-
-  auto Y_ = getY_(y);
-  auto yi = getY(y)[i];
+  auto &Y_ = cp.getY_();
+  auto &yi = cp.getYi()[i];
   for (size_t j = 0; j < n; j++)
   {
     mul(tmp, Y_[j], yi);
-    sub(tmp, ret->cell(0, j), tmp);
-    ret->cell(0, j, tmp);
+    sub(ret[j], ret[j], tmp);
   }
-
-  return ret;
 }
 
-ZZ_p CircuitZKPVerifier::K(const ZZ_p &y)
+ZZ_p CircuitZKPVerifier::K(const ChallengePowers &cp) const
 {
-  ZZ_p ret;
-  for (size_t q = 1; q <= Q; q++)
+  ZZ_pPush push(GP_P);
+  auto &Y_Mq = cp.getYMq();
+  ZZ_p ret, tmp;
+  for (size_t q = 0; q < Q; q++)
   {
-    auto kq = Kq(q);
+    auto &kq = Kq[q];
     if (IsZero(kq))
       continue;
 
-    ZZ_p KqYmq;
-
     if (IsOne(kq))
     {
-      KqYmq = getY_Mq(y, q);
+      add(ret, ret, Y_Mq[q]);
     }
     else
     {
-      mul(KqYmq, kq, getY_Mq(y, q));
+      mul(tmp, kq, Y_Mq[q]);
+      add(ret, ret, tmp);
     }
-    add(ret, ret, KqYmq);
   }
   return ret;
 }
 
-void CircuitZKPVerifier::createSx(const ZZ_p &y, vector<ZZ_pX> &sx)
+void CircuitZKPVerifier::createSx(const ChallengePowers &cp, vector<ZZ_pX> &sx) const
 {
   ZZ_pPush push(GP_P);
   sx.clear();
@@ -307,20 +202,21 @@ void CircuitZKPVerifier::createSx(const ZZ_p &y, vector<ZZ_pX> &sx)
 
   // s(X) = SUM(Wai(y) * y^-i * X^-i) + SUM(Wbi(y) * X^i) + X^-m * SUM(Wci(y) * X^-i)
   //      = (X^2m) * ( SUM(Wai(y) * y^-i * X^(2m-i)) + SUM(Wbi(y) * X^(2m+i)) + SUM(Wci(y) * X^(m-i)) )
-  Vec<ZZ_p> Y = getY(y); // [1, y, y^2, ... , y^m]
+  auto &invY = cp.getInvYi(); // [1, y^-1, y^-2, ... , y^-m]
   ZZ_p tmp;
 
   Timer::start("sx.wai");
+  Vec<ZZ_p> w;
   for (size_t i = 1; i <= m; i++)
   {
-    auto wai = Wai(i, y);
-    auto yi = inv(Y[i]);
+    Wai(i, cp, w);
+    auto &yi = invY[i];
 
-    for (auto it : wai->values[0])
+    for (size_t j = 0; j < n; j++)
     {
-      auto j = it.first;
-      auto v = it.second;
-      mul(tmp, v, yi);
+      if (IsZero(w[j]))
+        continue;
+      mul(tmp, w[j], yi);
       SetCoeff(sx[j], 2 * m - i, tmp);
     }
   }
@@ -329,12 +225,11 @@ void CircuitZKPVerifier::createSx(const ZZ_p &y, vector<ZZ_pX> &sx)
   Timer::start("sx.wbi");
   for (size_t i = 1; i <= m; i++)
   {
-    auto wbi = Wbi(i, y);
-    for (auto it : wbi->values[0])
+    Wbi(i, cp, w);
+    for (size_t j = 0; j < n; j++)
     {
-      auto j = it.first;
-      auto v = it.second;
-      SetCoeff(sx[j], 2 * m + i, v);
+      if (!IsZero(w[j]))
+        SetCoeff(sx[j], 2 * m + i, w[j]);
     }
   }
   Timer::end("sx.wbi");
@@ -342,17 +237,77 @@ void CircuitZKPVerifier::createSx(const ZZ_p &y, vector<ZZ_pX> &sx)
   Timer::start("sx.wci");
   for (size_t i = 1; i <= m; i++)
   {
-    auto wci = Wci(i, y);
-    for (auto it : wci->values[0])
+    Wci(i, cp, w);
+    for (size_t j = 0; j < n; j++)
     {
-      auto j = it.first;
-      auto v = it.second;
-      SetCoeff(sx[j], m - i, v);
+      if (!IsZero(w[j]))
+        SetCoeff(sx[j], m - i, w[j]);
     }
   }
   Timer::end("sx.wci");
 }
 
+void CircuitZKPVerifier::evalSx(const ChallengePowers &cp, Vec<ZZ_p> &ret) const
+{
+  ZZ_pPush push(GP_P);
+
+  // s(x) = SUM(Wai(y) * y^-i * x^-i) + SUM(Wbi(y) * x^i) + SUM(Wci(y) * x^(-m-i))
+  auto &Xi = cp.getXi();
+  auto &invXi = cp.getInvXi();
+  auto &invYi = cp.getInvYi();
+  auto &Y_Mq = cp.getYMq();
+  auto &Y = cp.getYi();
+  auto &Y_ = cp.getY_();
+
+  ret.SetLength(n);
+  clear(ret);
+
+  // each thread accumulates its rows of the wire entries, coeff * y^(M+q) * x^e
+  mutex lock;
+  Parallel::forRange(m, [&](size_t begin, size_t end) {
+    Vec<ZZ_p> partial;
+    partial.SetLength(n);
+    ZZ_p tmp;
+
+    auto accumulate = [&](const WireMat &W, size_t i, const ZZ_p &f) {
+      for (auto &e : W.row(i - 1))
+      {
+        mul(tmp, Y_Mq[e.q], f);
+        if (!IsOne(e.v))
+          mul(tmp, tmp, e.v);
+        add(partial[e.j], partial[e.j], tmp);
+      }
+    };
+
+    ZZ_p f;
+    for (size_t i = begin + 1; i <= end; i++)
+    {
+      mul(f, invYi[i], invXi[i]);
+      accumulate(*Wqa, i, f);
+      if (WqaPatch != nullptr)
+        accumulate(*WqaPatch, i, f);
+      accumulate(*Wqb, i, Xi[i]);
+      accumulate(*Wqc, i, invXi[m + i]);
+    }
+
+    lock_guard<mutex> guard(lock);
+    add(ret, ret, partial);
+  }, threads);
+
+  // the dense part of Wci(y): -SUM(y^i * x^(-m-i)) * Y'
+  ZZ_p sum, tmp;
+  for (size_t i = 1; i <= m; i++)
+  {
+    mul(tmp, Y[i], invXi[m + i]);
+    add(sum, sum, tmp);
+  }
+  for (size_t j = 0; j < n; j++)
+  {
+    mul(tmp, Y_[j], sum);
+    sub(ret[j], ret[j], tmp);
+  }
+}
+
 void CircuitZKPVerifier::setCommits(const Vec<ZZ_p> &commits)
 {
   if (commits.length() != 3 * m + 1)
@@ -365,21 +320,42 @@ void CircuitZKPVerifier::setCommits(const Vec<ZZ_p> &commits)
   commitD = commits[3 * m];
 }
 
-ZZ_p CircuitZKPVerifier::calculateY()
+ZZ_p CircuitZKPVerifier::calculateY(const ZZ &GP_P, const Vec<ZZ_p> &commits)
 {
-  auto seed = ConvertUtils::toBinary(commitD);
+  if (commits.length() % 3 != 1)
+    throw invalid_argument("commitments count is not correct");
+
+  size_t m = commits.length() / 3;
+  auto seed = ConvertUtils::toBinary(commits[3 * m]);
   for (size_t i = 0; i < m; i++)
   {
-    ConvertUtils::append(seed, ConvertUtils::toBinary(commitA[i]));
-    ConvertUtils::append(seed, ConvertUtils::toBinary(commitB[i]));
-    ConvertUtils::append(seed, ConvertUtils::toBinary(commitC[i]));
+    ConvertUtils::append(seed, ConvertUtils::toBinary(commits[i]));
+    ConvertUtils::append(seed, ConvertUtils::toBinary(commits[m + i]));
+    ConvertUtils::append(seed, ConvertUtils::toBinary(commits[2 * m + i]));
   }
 
+  RandomStreamPush push;
   SetSeed(seed.data(), seed.size());
   auto ret = MathUtils::randZZ_p(GP_P, true);
   return ret;
 }
 
+ZZ_p CircuitZKPVerifier::calculateY()
+{
+  Vec<ZZ_p> commits;
+  joinCommits(commits);
+  return calculateY(GP_P, commits);
+}
+
+void CircuitZKPVerifier::joinCommits(Vec<ZZ_p> &ret) const
+{
+  ret.SetLength(0);
+  ret.append(commitA);
+  ret.append(commitB);
+  ret.append(commitC);
+  ret.append(commitD);
+}
+
 void CircuitZKPVerifier::setPolyCommits(const Vec<ZZ_p> &pc)
 {
   if (pc.length() != txM1 + txM2 + 1)
@@ -388,71 +364,44 @@ void CircuitZKPVerifier::setPolyCommits(const Vec<ZZ_p> &pc)
   this->pc = pc;
 }
 
-ZZ_p CircuitZKPVerifier::calculateX()
+ZZ_p CircuitZKPVerifier::calculateX(const ZZ &GP_P, const Vec<ZZ_p> &pc)
 {
+  if (pc.length() == 0)
+    throw invalid_argument("polynomial commitments count is not correct");
+
   auto seed = ConvertUtils::toBinary(pc[0]);
-  for (size_t i = 1; i < pc.length(); i++)
+  for (long i = 1; i < pc.length(); i++)
   {
     ConvertUtils::append(seed, ConvertUtils::toBinary(pc[i]));
   }
 
+  RandomStreamPush push;
   SetSeed(seed.data(), seed.size());
   auto ret = MathUtils::randZZ_p(GP_P, true);
   return ret;
 }
 
-bool CircuitZKPVerifier::verify(const Vec<ZZ_p> &proofs, const ZZ_p &y, const ZZ_p &x)
+ZZ_p CircuitZKPVerifier::calculateX()
 {
-  Timer::start("verifier.verify");
-  // check proof size
-  if (proofs.length() != txN + 1 + n + 1)
-    return false;
-
-  ZZ_pPush push(GP_Q);
-
-  // extract pe, r, rr from proofs
-  Vec<ZZ_p> pe;
-  Vec<ZZ_p> r;
-  ConvertUtils::subVec(proofs, pe, 0, txN + 1);
-  ConvertUtils::subVec(proofs, r, txN + 1, txN + 1 + n);
-  ZZ_p rr = proofs[proofs.length() - 1];
+  return calculateX(GP_P, pc);
+}
 
+bool CircuitZKPVerifier::checkValue(const Vec<ZZ_p> &pe, const Vec<ZZ_p> &r, const ChallengePowers &cp) const
+{
+  ZZ_pPush push(GP_P);
   ZZ_p tmp;
 
-  // check PolyVerify
-  Timer::start("verifier.polyVerify");
-  if (!commitScheme->verify(txM1, txM2, txN, pc, pe, x))
-    return false;
-  Timer::end("verifier.polyVerify");
-
   // setting: u = 0
   // check PolyEval = r dot r' - 2K
   Timer::start("verifier.calcV1");
-  auto v1 = commitScheme->calcV(txN, pe, x);
+  auto v1 = commitScheme->calcV(txN, pe, cp.getX());
   Timer::end("verifier.calcV1");
 
   Timer::start("verifier.calcV2");
-  Timer::start("verifier.setY");
-  setY(y); // recalculate cachedY_ and cachedY_Mq
-  Timer::end("verifier.setY");
-
   Timer::start("verifier.sx");
-  ZZ_p::init(GP_P);
-
-  // create polynomial s(X)
-  vector<ZZ_pX> sx;
-  createSx(y, sx);
-
-  // put x into s(X)
+  // put y, x into s(X) without creating the polynomials
   Vec<ZZ_p> sx2;
-  sx2.SetLength(n);
-  for (size_t i = 0; i < n; i++)
-  {
-    eval(sx2[i], sx[i], x);
-  }
-  // shift x^-2m, since the NTL polynomial only support positive degree
-  power(tmp, x, -2 * m);
-  mul(sx2, sx2, tmp);
+  evalSx(cp, sx2);
   mul(sx2, sx2, 2); // 2 * s(x)
   Timer::end("verifier.sx");
 
@@ -460,7 +409,7 @@ bool CircuitZKPVerifier::verify(const Vec<ZZ_p> &proofs, const ZZ_p &y, const ZZ
   Timer::start("verifier.r_");
   Vec<ZZ_p> r_;
   r_.SetLength(n);
-  const auto y_ = getY_(y);
+  auto &y_ = cp.getY_();
   for (size_t i = 0; i < n; i++)
   {
     mul(r_[i], r[i], y_[i]);
@@ -472,57 +421,233 @@ bool CircuitZKPVerifier::verify(const Vec<ZZ_p> &proofs, const ZZ_p &y, const ZZ
   Timer::start("verifier.rr_");
   ZZ_p v2;
   InnerProduct(v2, r, r_); // r * r'
-  tmp = K(y);              // put y into K(y)
+  tmp = K(cp);             // put y into K(y)
   mul(tmp, tmp, 2);        // 2 * K(y)
   sub(v2, v2, tmp);        // r * r' - 2K
   Timer::end("verifier.rr_");
   Timer::end("verifier.calcV2");
 
-  if (v1 != v2)
+  return v1 == v2;
+}
+
+bool CircuitZKPVerifier::verify(const Vec<ZZ_p> &proofs, const ZZ_p &y, const ZZ_p &x)
+{
+  return verify(proofs, challengePowers(y, x));
+}
+
+bool CircuitZKPVerifier::verify(const Vec<ZZ_p> &proofs, const ChallengePowers &cp)
+{
+  Vec<ZZ_p> commits;
+  joinCommits(commits);
+  return checkProof(commits, pc, proofs, cp);
+}
+
+bool CircuitZKPVerifier::verify(const Vec<ZZ_p> &commits, const Vec<ZZ_p> &pc, const Vec<ZZ_p> &proofs) const
+{
+  if (commits.length() != 3 * m + 1 || pc.length() != txM1 + txM2 + 1)
+    return false;
+
+  auto y = calculateY(GP_P, commits);
+  auto x = calculateX(GP_P, pc);
+  return checkProof(commits, pc, proofs, challengePowers(y, x));
+}
+
+bool CircuitZKPVerifier::checkProof(const Vec<ZZ_p> &commits, const Vec<ZZ_p> &pc, const Vec<ZZ_p> &proofs, const ChallengePowers &cp) const
+{
+  auto &x = cp.getX();
+
+  Timer::start("verifier.verify");
+  // check proof size
+  if (proofs.length() != txN + 1 + n + 1)
+    return false;
+
+  ZZ_pPush push(GP_Q);
+
+  // extract pe, r, rr from proofs
+  Vec<ZZ_p> pe;
+  Vec<ZZ_p> r;
+  ConvertUtils::subVec(proofs, pe, 0, txN + 1);
+  ConvertUtils::subVec(proofs, r, txN + 1, txN + 1 + n);
+  ZZ_p rr = proofs[proofs.length() - 1];
+
+  // check PolyVerify
+  Timer::start("verifier.polyVerify");
+  if (!commitScheme->verify(txM1, txM2, txN, pc, pe, x))
+    return false;
+  Timer::end("verifier.polyVerify");
+
+  if (!checkValue(pe, r, cp))
     return false;
 
-  // check commit(r, rr) is correct
-  Timer::start("verifier.commitR1");
-  auto c1 = commitScheme->commit(r, rr);
-  Timer::end("verifier.commitR1");
+  // check commit(r, rr) is correct, both sides in one multi-exponentiation
+  Timer::start("verifier.commitR");
+  Equation eq;
+  commitEquation(commits, r, rr, cp, eq);
+  auto isValid = commitScheme->isIdentity(commitScheme->commitExps(eq.exps, commitScheme->threads, eq.bases, eq.baseExps));
+  Timer::end("verifier.commitR");
 
-  Timer::start("verifier.commitR2");
-  ZZ_p::init(GP_P);
-  ZZ_p c2 = conv<ZZ_p>(1);
-  ZZ_p xi = conv<ZZ_p>(1);
-  ZZ_p yi = conv<ZZ_p>(1);
-  ZZ_p xmi = power(x, m);
-  ZZ_p xi_;
+  Timer::end("verifier.verify");
+  return isValid;
+}
+
+void CircuitZKPVerifier::commitEquation(const Vec<ZZ_p> &r, const ZZ_p &rr, const ChallengePowers &cp, Equation &ret) const
+{
+  Vec<ZZ_p> commits;
+  joinCommits(commits);
+  commitEquation(commits, r, rr, cp, ret);
+}
 
-  for (int i = 1; i <= m; i++)
+void CircuitZKPVerifier::commitEquation(const Vec<ZZ_p> &commits, const Vec<ZZ_p> &r, const ZZ_p &rr, const ChallengePowers &cp, Equation &ret) const
+{
+  if (commits.length() != 3 * m + 1)
+    throw invalid_argument("commitments count is not correct");
+
+  // commit(r, rr) = Product(Ai ^ (x^i * y^i)) * Product(Bi ^ x^-i) * Product(Ci ^ x^(m+i)) * D ^ x^(2m+1)
+  // g^-rr * Product(gi ^ -r) * Product(Ai ^ ...) * ... * D ^ x^(2m+1) = 1
+  ZZ_pPush push(GP_P);
+
+  ret.exps.SetLength(r.length() + 1);
+  ret.exps[0] = -rep(rr);
+  for (long i = 0; i < r.length(); i++)
+    ret.exps[i + 1] = -rep(r[i]);
+
+  auto &xs = cp.getXi();     // [1, x, ..., x^(2m+1)]
+  auto &xs_ = cp.getInvXi(); // [1, x^-1, ..., x^-2m]
+  auto &ys = cp.getYi();     // [1, y, ..., y^m]
+
+  ret.bases.SetLength(3 * m + 1);
+  ret.baseExps.SetLength(3 * m + 1);
+  for (size_t i = 1; i <= m; i++)
   {
-    ZZ_p::init(GP_P);
-    mul(xi, xi, x);
-    mul(yi, yi, y);
-    mul(xmi, xmi, x);
-    inv(xi_, xi);
-
-    mul(tmp, xi, yi);
-    ZZ_p::init(GP_Q);
-    power(tmp, commitA[i - 1], conv<ZZ>(tmp));
-    mul(c2, c2, tmp);
-    power(tmp, commitB[i - 1], conv<ZZ>(xi_));
-    mul(c2, c2, tmp);
-    power(tmp, commitC[i - 1], conv<ZZ>(xmi));
-    mul(c2, c2, tmp);
+    ret.bases[i - 1] = commits[i - 1];
+    ret.baseExps[i - 1] = rep(xs[i] * ys[i]);
+    ret.bases[m + i - 1] = commits[m + i - 1];
+    ret.baseExps[m + i - 1] = rep(xs_[i]);
+    ret.bases[2 * m + i - 1] = commits[2 * m + i - 1];
+    ret.baseExps[2 * m + i - 1] = rep(xs[m + i]);
   }
+  ret.bases[3 * m] = commits[3 * m];
+  ret.baseExps[3 * m] = rep(xs[2 * m + 1]);
+}
 
-  ZZ_p::init(GP_P);
-  power(tmp, x, 2 * m + 1);
-  ZZ_p::init(GP_Q);
-  power(tmp, commitD, conv<ZZ>(tmp));
-  mul(c2, c2, tmp);
-  Timer::end("verifier.commitR2");
+vector<bool> CircuitZKPVerifier::verifyBatch(
+    const vector<shared_ptr<CircuitZKPVerifier>> &verifiers,
+    const vector<Vec<ZZ_p>> &proofs,
+    const Vec<ZZ_p> &ys,
+    const Vec<ZZ_p> &xs)
+{
+  size_t count = verifiers.size();
+  if (proofs.size() != count || ys.length() != count || xs.length() != count)
+    throw invalid_argument("verifiers, proofs and challenges count mismatch");
 
-  Timer::end("verifier.verify");
+  vector<bool> ret(count, false);
+  if (count == 0)
+    return ret;
 
-  if (c1 != c2)
-    return false;
+  auto scheme = verifiers[0]->commitScheme;
+  for (auto &v : verifiers)
+  {
+    auto &s = v->commitScheme;
+    if (s->Q != scheme->Q || s->p != scheme->p || s->g != scheme->g || s->gi != scheme->gi)
+      throw invalid_argument("verifiers do not share the same commitment parameters");
+  }
+
+  // scalar checks per proof, two group equations per passed proof
+  vector<vector<Equation>> equations(count);
+  vector<size_t> pending;
+  for (size_t k = 0; k < count; k++)
+  {
+    auto &v = verifiers[k];
+    auto &proof = proofs[k];
+    if (proof.length() != v->txN + 1 + v->n + 1)
+      continue;
 
-  return true;
+    Vec<ZZ_p> pe;
+    Vec<ZZ_p> r;
+    ConvertUtils::subVec(proof, pe, 0, v->txN + 1);
+    ConvertUtils::subVec(proof, r, v->txN + 1, v->txN + 1 + v->n);
+    ZZ_p rr = proof[proof.length() - 1];
+
+    auto cp = v->challengePowers(ys[k], xs[k]);
+    if (!v->checkValue(pe, r, cp))
+      continue;
+
+    Vec<ZZ_p> commits;
+    v->joinCommits(commits);
+
+    equations[k].resize(2);
+    auto &poly = equations[k][0];
+    poly.bases = v->pc;
+    scheme->verifyEquation(v->txM1, v->txM2, v->txN, v->pc, pe, xs[k], poly.exps, poly.baseExps);
+    v->commitEquation(commits, r, rr, cp, equations[k][1]);
+    pending.push_back(k);
+  }
+
+  // Q - 1 = f * p, so Z_Q* has elements of small order (eg. -1) that could cancel
+  // out under the weights. The weights carry the factor f to clear them, the
+  // exponents of g and gi are then reduced mod f * p = Q - 1
+  ZZ order = scheme->Q - 1;
+  ZZ f;
+  div(f, order, scheme->p);
+
+  // the weights must not be predictable by the prover, the NTL generator is seeded by the challenges
+  random_device rd;
+  auto weight = [&rd, &f]() {
+    uint8_t bytes[BATCH_WEIGHT_BITS / 8];
+    for (auto &b : bytes)
+      b = rd();
+    bytes[0] |= 1;
+    return ZZFromBytes(bytes, sizeof(bytes)) * f;
+  };
+
+  // Product(equation ^ w) = 1 for random w
+  auto check = [&](const vector<size_t> &indices) {
+    Vec<ZZ> exps;
+    Vec<ZZ_p> bases;
+    Vec<ZZ> baseExps;
+    exps.SetLength(scheme->gi.length() + 1);
+    ZZ w, e;
+    for (auto k : indices)
+    {
+      for (auto &eq : equations[k])
+      {
+        w = weight();
+        for (long i = 0; i < eq.exps.length(); i++)
+        {
+          mul(e, eq.exps[i], w);
+          add(exps[i], exps[i], e);
+        }
+        for (long i = 0; i < eq.bases.length(); i++)
+        {
+          bases.append(eq.bases[i]);
+          baseExps.append(eq.baseExps[i] * w);
+        }
+      }
+    }
+    for (long i = 0; i < exps.length(); i++)
+      rem(exps[i], exps[i], order);
+
+    return IsOne(scheme->commitExps(exps, scheme->threads, bases, baseExps));
+  };
+
+  // bisect the failed batches
+  function<void(const vector<size_t> &)> bisect = [&](const vector<size_t> &indices) {
+    if (indices.empty())
+      return;
+    if (check(indices))
+    {
+      for (auto k : indices)
+        ret[k] = true;
+      return;
+    }
+    if (indices.size() == 1)
+      return;
+
+    size_t half = indices.size() / 2;
+    bisect(vector<size_t>(indices.begin(), indices.begin() + half));
+    bisect(vector<size_t>(indices.begin() + half, indices.end()));
+  };
+  bisect(pending);
+
+  return ret;
 }
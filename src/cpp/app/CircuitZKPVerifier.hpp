@@ -11,9 +11,11 @@
 #include <NTL/matrix.h>
 
 #include "./PolynomialCommitment.hpp"
+#include "./ChallengePowers.hpp"
 #include "./math/MathUtils.hpp"
 #include "./utils/ConvertUtils.hpp"
 #include "./math/Matrix.hpp"
+#include "./math/WireMat.hpp"
 #include "./utils/Timer.hpp"
 
 namespace polyu
@@ -25,21 +27,55 @@ namespace polyu
 class CircuitZKPVerifier
 {
 private:
-  // Y = [1, y, y^2, ... , y^m]
-  Vec<ZZ_p> cachedY;
+  // ret[j] += SUM(w_q[i][j] * y^(M+q))
+  void wireRow(const WireMat &W, size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const;
 
-  // Y' = [y^m, y^2m, ... , y^mn]
-  Vec<ZZ_p> cachedY_;
+  // check v1 = t(x) against v2 = r * r' - 2K(y)
+  bool checkValue(const Vec<ZZ_p> &pe, const Vec<ZZ_p> &r, const ChallengePowers &cp) const;
 
-  // Y_Mq = [y^(M+1), y^(M+2), ... , y^(M+Q)]
-  Vec<ZZ_p> cachedY_Mq;
+  // [commitA, commitB, commitC, commitD]
+  void joinCommits(Vec<ZZ_p> &ret) const;
 
-  Vec<ZZ_p> &getY_Mq(const ZZ_p &y);
-  ZZ_p getY_Mq(const ZZ_p &y, size_t q); // q: 1 to Q
-
-  void convertWire(const vector<shared_ptr<Matrix>> &source, map<size_t, map<size_t, map<size_t, ZZ_p>>> &target);
+  // verify the proofs against the given commitments only
+  bool checkProof(const Vec<ZZ_p> &commits, const Vec<ZZ_p> &pc, const Vec<ZZ_p> &proofs, const ChallengePowers &cp) const;
 
 public:
+  /**
+   * @brief Group equation g^exps[0] * Product(gi ^ exps[i + 1]) * Product(bases ^ baseExps) = 1
+   */
+  struct Equation
+  {
+    /// @brief Signed exponents of g and gi
+    Vec<ZZ> exps;
+
+    /// @brief Other bases, eg. commitments
+    Vec<ZZ_p> bases;
+
+    /// @brief Non-negative exponents of the other bases
+    Vec<ZZ> baseExps;
+  };
+
+  /// @brief Length of the random weights in batch verification, in bits
+  static const long BATCH_WEIGHT_BITS = 64;
+
+  /**
+   * @brief Calculate challenge value (y) base on commitment values, used in non-interactive mode. The seeding is scoped, the random stream of the calling thread is restored afterwards
+   *
+   * @param GP_P Group element p
+   * @param commits Commitment values [A1, ... , Am, B1, ... , Bm, C1, ... , Cm, D]
+   * @return ZZ_p
+   */
+  static ZZ_p calculateY(const ZZ &GP_P, const Vec<ZZ_p> &commits);
+
+  /**
+   * @brief Calculate challenge value (x) base on polynomial commitments result (pc), used in non-interactive mode. The seeding is scoped, the random stream of the calling thread is restored afterwards
+   *
+   * @param GP_P Group element p
+   * @param pc Polynomial commitments result
+   * @return ZZ_p
+   */
+  static ZZ_p calculateX(const ZZ &GP_P, const Vec<ZZ_p> &pc);
+
   /**
    * @brief Calculate the matrix size (m * n) base on the number of multiplication gates (gateCount) in circuit
    *
@@ -65,14 +101,17 @@ public:
   /// @brief Group generator g
   ZZ_p GP_G;
 
-  /// @brief Linear constrains w_q,a; stored as map(i, q, j)
-  map<size_t, map<size_t, map<size_t, ZZ_p>>> Wqa;
+  /// @brief Linear constrains w_q,a; stored as sparse rows of (q, j), can be shared between verifiers of the same circuit
+  shared_ptr<const WireMat> Wqa;
+
+  /// @brief Linear constrains w_q,b; stored as sparse rows of (q, j), can be shared between verifiers of the same circuit
+  shared_ptr<const WireMat> Wqb;
 
-  /// @brief Linear constrains w_q,b; stored as
-  map<size_t, map<size_t, map<size_t, ZZ_p>>> Wqb;
+  /// @brief Linear constrains w_q,c; stored as sparse rows of (q, j), can be shared between verifiers of the same circuit
+  shared_ptr<const WireMat> Wqc;
 
-  /// @brief Linear constrains w_q,c; stored as
-  map<size_t, map<size_t, map<size_t, ZZ_p>>> Wqc;
+  /// @brief Per-proof linear constrains added on top of w_q,a, eg. the challenge dependent rows of a preprocessed circuit; null if none
+  shared_ptr<const WireMat> WqaPatch;
 
   /// @brief Linear constrains K_q
   Vec<ZZ_p> Kq;
@@ -119,6 +158,9 @@ public:
   /// @brief Polynomial commitment (pc)
   Vec<ZZ_p> pc;
 
+  /// @brief Thread budget of evaluating s(x), 0 means use the default thread budget
+  size_t threads = 0;
+
   /**
    * @brief Construct a new Circuit ZKP Verifier object
    *
@@ -165,57 +207,95 @@ public:
       size_t n,
       size_t Q);
 
-  /// @private
-  Vec<ZZ_p> &getY(const ZZ_p &y);
+  /**
+   * @brief Construct a new Circuit ZKP Verifier object from converted linear constrains, the matrix size (m, n) is taken from Wqa
+   *
+   * @param GP_Q Group element Q
+   * @param GP_P Group element p
+   * @param GP_G Group generator g
+   * @param Wqa Linear constrains w_q,a
+   * @param Wqb Linear constrains w_q,b
+   * @param Wqc Linear constrains w_q,c
+   * @param Kq Linear constrains K_q
+   * @param commitScheme Polynomial commitment scheme, it can be shared between verifiers
+   */
+  CircuitZKPVerifier(
+      const ZZ &GP_Q,
+      const ZZ &GP_P,
+      const ZZ_p &GP_G,
+      const shared_ptr<const WireMat> &Wqa,
+      const shared_ptr<const WireMat> &Wqb,
+      const shared_ptr<const WireMat> &Wqc,
+      const Vec<ZZ_p> &Kq,
+      const shared_ptr<PolynomialCommitment> &commitScheme);
 
-  /// @private
-  Vec<ZZ_p> &getY_(const ZZ_p &y);
+  /**
+   * @brief Powers of challenge value (y) of this circuit
+   *
+   * @param y Challenge value (y)
+   * @return ChallengePowers
+   */
+  ChallengePowers challengePowers(const ZZ_p &y) const;
 
-  /// @private
-  void setY(const ZZ_p &y); // recalculated cachedY, cachedY_, cachedY_Mq
+  /**
+   * @brief Powers of challenge values (y, x) of this circuit
+   *
+   * @param y Challenge value (y)
+   * @param x Challenge value (x)
+   * @return ChallengePowers
+   */
+  ChallengePowers challengePowers(const ZZ_p &y, const ZZ_p &x) const;
 
   /**
    * @brief Function w_a,i(Y)
    *
    * @param i
-   * @param y Challenge value (y)
-   * @return shared_ptr<Matrix>
+   * @param cp Powers of challenge value (y)
+   * @param ret Result row of length n, the storage is reused
    */
-  shared_ptr<Matrix> Wai(size_t i, const ZZ_p &y);
+  void Wai(size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const;
 
   /**
    * @brief Function w_b,i(Y)
    *
    * @param i
-   * @param y Challenge value (y)
-   * @return shared_ptr<Matrix>
+   * @param cp Powers of challenge value (y)
+   * @param ret Result row of length n, the storage is reused
    */
-  shared_ptr<Matrix> Wbi(size_t i, const ZZ_p &y);
+  void Wbi(size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const;
 
   /**
    * @brief Function w_c,i(Y)
    *
    * @param i
-   * @param y Challenge value (y)
-   * @return shared_ptr<Matrix>
+   * @param cp Powers of challenge value (y)
+   * @param ret Result row of length n, the storage is reused
    */
-  shared_ptr<Matrix> Wci(size_t i, const ZZ_p &y);
+  void Wci(size_t i, const ChallengePowers &cp, Vec<ZZ_p> &ret) const;
 
   /**
    * @brief Function K(Y)
    *
-   * @param y Challenge value (y)
+   * @param cp Powers of challenge value (y)
    * @return ZZ_p
    */
-  ZZ_p K(const ZZ_p &y);
+  ZZ_p K(const ChallengePowers &cp) const;
 
   /**
    * @brief Create polynomial s(X)
    *
-   * @param y Challenge value (y)
+   * @param cp Powers of challenge value (y)
    * @param output Result
    */
-  void createSx(const ZZ_p &y, vector<ZZ_pX> &output);
+  void createSx(const ChallengePowers &cp, vector<ZZ_pX> &output) const;
+
+  /**
+   * @brief Evaluate s(x) with challenge value (y) directly from the nonzero wire entries, the polynomials s(X) are not created
+   *
+   * @param cp Powers of challenge values (y, x)
+   * @param ret Result s(x) of length n
+   */
+  void evalSx(const ChallengePowers &cp, Vec<ZZ_p> &ret) const;
 
   /**
    * @brief Update the commiment values (commitA, commitB, commitC, commitD) given by prover
@@ -255,6 +335,63 @@ public:
    * @return false
    */
   bool verify(const Vec<ZZ_p> &proofs, const ZZ_p &y, const ZZ_p &x);
+
+  /**
+   * @brief Verify the proofs for the circuit
+   *
+   * @param proofs The proofs list
+   * @param cp Powers of challenge values (y, x)
+   * @return true
+   * @return false
+   */
+  bool verify(const Vec<ZZ_p> &proofs, const ChallengePowers &cp);
+
+  /**
+   * @brief Verify the proofs without the proof state of the verifier (commits, pc), the challenge values are derived from the given commitments. It only reads the verifier, so concurrent calls are safe
+   *
+   * @param commits Commitment values
+   * @param pc Polynomial commitments result
+   * @param proofs The proofs list
+   * @return true
+   * @return false
+   */
+  bool verify(const Vec<ZZ_p> &commits, const Vec<ZZ_p> &pc, const Vec<ZZ_p> &proofs) const;
+
+  /**
+   * @brief Build the group equation of the commit(r, rr) check
+   *
+   * @param r Proof value (r)
+   * @param rr Proof value (rr)
+   * @param cp Powers of challenge values (y, x)
+   * @param ret Result
+   */
+  void commitEquation(const Vec<ZZ_p> &r, const ZZ_p &rr, const ChallengePowers &cp, Equation &ret) const;
+
+  /**
+   * @brief Build the group equation of the commit(r, rr) check with the given commitments
+   *
+   * @param commits Commitment values
+   * @param r Proof value (r)
+   * @param rr Proof value (rr)
+   * @param cp Powers of challenge values (y, x)
+   * @param ret Result
+   */
+  void commitEquation(const Vec<ZZ_p> &commits, const Vec<ZZ_p> &r, const ZZ_p &rr, const ChallengePowers &cp, Equation &ret) const;
+
+  /**
+   * @brief Verify many proofs at once. The scalar checks run per proof, the group equations of all proofs are combined with random weights into one multi-exponentiation. If the combined check fails, the proofs are bisected to find the invalid ones. The weights carry the cofactor f = (Q - 1) / p, so components of small order are cleared instead of cancelling out under the weights, the same as in verify. All verifiers must share the same commitment parameters (Q, g, gi)
+   *
+   * @param verifiers Verifiers with the commitments (commits, pc) of each proof
+   * @param proofs The proofs list of each proof
+   * @param ys Challenge value y of each proof
+   * @param xs Challenge value x of each proof
+   * @return vector<bool> Result of each proof
+   */
+  static vector<bool> verifyBatch(
+      const vector<shared_ptr<CircuitZKPVerifier>> &verifiers,
+      const vector<Vec<ZZ_p>> &proofs,
+      const Vec<ZZ_p> &ys,
+      const Vec<ZZ_p> &xs);
 };
 
 } // namespace polyu
@@ -17,12 +17,14 @@
 #include "./CBatchEnc.hpp"
 #include "./CircuitZKPVerifier.hpp"
 #include "./CircuitZKPProver.hpp"
+#include "./ParamBundle.hpp"
+#include "./VerifierKey.hpp"
 
 namespace polyu
 {
 
 void end_to_end(size_t byteLength, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs);
-void end_to_end(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs);
+void end_to_end(const shared_ptr<PaillierEncryption> &crypto, size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch, ofstream &fs, const shared_ptr<ParamBundle> &params = nullptr, const shared_ptr<VerifierKey> &key = nullptr);
 
 // ZZ_p help_random(ZZ max);
 } // namespace polyu
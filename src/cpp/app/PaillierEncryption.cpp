@@ -6,7 +6,14 @@ PaillierEncryption::PaillierEncryption(size_t byteLength)
 
 // Generate a new Keypair with seed
 PaillierEncryption::PaillierEncryption(size_t byteLength, const binary_t &seed)
+    : PaillierEncryption(byteLength, seed, 0) {}
+
+// Generate a new Keypair with seed, concurrently
+PaillierEncryption::PaillierEncryption(size_t byteLength, const binary_t &seed, size_t threads, const KeyGenCallback &callback)
 {
+  this->threads = threads;
+  this->callback = callback;
+
   if (seed.size() > 0)
   {
     SetSeed(seed.data(), seed.size());
@@ -17,13 +24,23 @@ PaillierEncryption::PaillierEncryption(size_t byteLength, const binary_t &seed)
 
   do
   {
-    GenPrime(p, length);
-    GenPrime(q, length);
+    // p and q are searched concurrently, each from its own random stream
+    ZZ seeds[2] = {RandomBits_ZZ(256), RandomBits_ZZ(256)};
+    ZZ primes[2];
+    Parallel::forRange(2, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; i++)
+        primes[i] = genPrime(length, seeds[i], i == 0 ? "p" : "q");
+    }, threads);
+
+    p = primes[0];
+    q = primes[1];
     n = p * q;
   } while (p == q);
 
   init();
   ZZ_p::init(Q);
+
+  this->callback = nullptr;
 }
 
 // Import KeyPair from N (public key) and group elements, can perform encrypt
@@ -62,6 +79,12 @@ PaillierEncryption::PaillierEncryption(const ZZ &N,
   ZZ_p::init(Q);
 }
 
+PaillierEncryption::~PaillierEncryption()
+{
+  // the pool workers refer to this instance
+  detachPool();
+}
+
 // init value n2, g, mu
 void PaillierEncryption::init(bool skipGenerate)
 {
@@ -86,19 +109,38 @@ void PaillierEncryption::init(bool skipGenerate)
   ZZ_p::init(n2);
   g = conv<ZZ_p>(n + 1);
 
+  // CRT parameters for decryption
+  // hp = L_p(g^(p-1) mod p^2)^-1 mod p, hq = L_q(g^(q-1) mod q^2)^-1 mod q
+  if (p != 0 && q != 0)
+  {
+    p2 = p * p;
+    q2 = q * q;
+
+    ZZ x;
+    PowerMod(x, (n + 1) % p2, p - 1, p2);
+    div(hp, x - 1, p);
+    InvMod(hp, hp, p);
+
+    PowerMod(x, (n + 1) % q2, q - 1, q2);
+    div(hq, x - 1, q);
+    InvMod(hq, hq, q);
+
+    InvMod(pInvQ, p % q, q);
+
+    // CRT parameters for r^n mod n^2
+    np = n % (p * (p - 1));
+    nq = n % (q * (q - 1));
+    InvMod(p2InvQ2, p2 % q2, q2);
+  }
+
   // Cyclic group parameters
   // calculate value Q, G
 
   if (p == 0 || q == 0)
     return;
 
-  for (size_t i = 2; true; i++)
-  {
-    f = i;
-    Q = (f * n2) + 1;
-    if (ProbPrime(Q))
-      break;
-  }
+  f = searchGroupFactor();
+  Q = (f * n2) + 1;
 
   if (skipGenerate)
     return;
@@ -107,6 +149,95 @@ void PaillierEncryption::init(bool skipGenerate)
   G = genGenerator();
 }
 
+void PaillierEncryption::notify(const string &stage, size_t count)
+{
+  if (callback == nullptr)
+    return;
+
+  lock_guard<mutex> guard(notifyLock);
+  if (!cancelled && !callback(stage, count))
+    cancelled = true;
+  if (cancelled)
+    throw runtime_error("key generation cancelled");
+}
+
+ZZ PaillierEncryption::genPrime(long length, const ZZ &seed, const string &stage)
+{
+  RandomStreamPush push;
+  SetSeed(seed);
+
+  ZZ x;
+  for (size_t count = 1; true; count++)
+  {
+    notify(stage, count);
+
+    RandomLen(x, length);
+    SetBit(x, 0);
+    if (ProbPrime(x))
+      return x;
+  }
+}
+
+ZZ PaillierEncryption::searchGroupFactor()
+{
+  // Q = f * n2 + 1 is divisible by a small prime s iff f = -(n2^-1) mod s,
+  // s < n2 < Q so that a prime Q is never sieved out
+  vector<long> primes;
+  vector<long> roots;
+  PrimeSeq seq;
+  for (long s = seq.next(); s < 2000 && s < n2; s = seq.next())
+  {
+    long r = rem(n2, s);
+    if (r == 0)
+      continue;
+    primes.push_back(s);
+    roots.push_back((s - InvMod(r, s)) % s);
+  }
+
+  const long window = 1024;
+  size_t batch = Parallel::threadCount(threads) * 4;
+  atomic<size_t> count(0);
+
+  for (long base = 2; true; base += window)
+  {
+    vector<bool> sieved(window, false);
+    for (size_t k = 0; k < primes.size(); k++)
+    {
+      long s = primes[k];
+      for (long i = (roots[k] - base % s + s) % s; i < window; i += s)
+        sieved[i] = true;
+    }
+
+    vector<long> candidates;
+    for (long i = 0; i < window; i++)
+    {
+      if (!sieved[i])
+        candidates.push_back(base + i);
+    }
+
+    // test a batch at a time and keep the smallest prime, same result as a serial search
+    for (size_t begin = 0; begin < candidates.size(); begin += batch)
+    {
+      size_t len = min(batch, candidates.size() - begin);
+      vector<char> found(len, 0);
+      Parallel::forRange(len, [&](size_t b, size_t e) {
+        RandomStreamPush push;
+        for (size_t i = b; i < e; i++)
+        {
+          notify("Q", ++count);
+          found[i] = ProbPrime(candidates[begin + i] * n2 + 1);
+        }
+      }, threads);
+
+      for (size_t i = 0; i < len; i++)
+      {
+        if (found[i])
+          return conv<ZZ>(candidates[begin + i]);
+      }
+    }
+  }
+}
+
 ZZ_p PaillierEncryption::genGenerator()
 {
   if (p == 0 || q == 0 || f == 0)
@@ -115,41 +246,27 @@ ZZ_p PaillierEncryption::genGenerator()
   ZZ_pPush push(Q);
   ZZ_p G0;
   ZZ_p y;
-  while (true)
+  ZZ pq = p * q;
+  for (size_t count = 1; true; count++)
   {
+    notify("G", count);
+
+    // G0 = y^f is in the subgroup of order n^2 = p^2 * q^2, it generates
+    // the subgroup iff G0^(p * q^2) != 1 and G0^(p^2 * q) != 1
     random(y);
     power(G0, y, f);
 
-    ZZ_p x;
-    power(x, G0, n2);
-    if (x != 1)
-      continue;
-
-    power(x, G0, p);
-    if (x == 1)
+    ZZ_p t;
+    power(t, G0, pq);
+    if (t == 1)
       continue;
 
-    power(x, G0, q);
-    if (x == 1)
-      continue;
-
-    power(x, G0, p * q);
-    if (x == 1)
-      continue;
-
-    power(x, G0, p * p);
-    if (x == 1)
-      continue;
-
-    power(x, G0, q * q);
-    if (x == 1)
-      continue;
-
-    power(x, G0, p * p * q);
+    ZZ_p x;
+    power(x, t, q);
     if (x == 1)
       continue;
 
-    power(x, G0, q * q * p);
+    power(x, t, p);
     if (x == 1)
       continue;
 
@@ -158,14 +275,30 @@ ZZ_p PaillierEncryption::genGenerator()
   return G0;
 }
 
+ZZ_p PaillierEncryption::genGenerator(const ZZ &seed, size_t index)
+{
+  // the k-th generator only depends on (seed, k)
+  RandomStreamPush push;
+  SetSeed((seed << 64) + index);
+  return genGenerator();
+}
+
 Vec<ZZ_p> PaillierEncryption::genGenerators(size_t n)
+{
+  return genGenerators(n, RandomBits_ZZ(256));
+}
+
+Vec<ZZ_p> PaillierEncryption::genGenerators(size_t n, const ZZ &seed, size_t threads)
 {
   Vec<ZZ_p> ret;
   ret.SetLength(n);
-  for (size_t i = 0; i < n; i++)
-  {
-    ret[i] = genGenerator();
-  }
+
+  Parallel::forRange(n, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      ret[i] = genGenerator(seed, i);
+    }
+  }, threads);
   return ret;
 }
 
@@ -195,6 +328,37 @@ ZZ_p PaillierEncryption::getGroupG()
   return G;
 }
 
+bool PaillierEncryption::isKeyHolder()
+{
+  return p != 0 && q != 0;
+}
+
+ZZ PaillierEncryption::crtN2(const ZZ &xp, const ZZ &xq)
+{
+  // x = xp + p^2 * ((xq - xp) * (p^2)^-1 mod q^2)
+  ZZ t;
+  sub(t, xq, xp);
+  rem(t, t, q2);
+  MulMod(t, t, p2InvQ2, q2);
+  return xp + p2 * t;
+}
+
+ZZ_p PaillierEncryption::powerN(const ZZ_p &r)
+{
+  ZZ_pPush push(n2);
+  // recoding n takes < 0.1% of one exponentiation and a recoded schedule over
+  // generic multiplications is slower than power, so n is not precomputed
+  if (!isKeyHolder())
+    return power(r, n);
+
+  // r^n mod p^2 = r^(n mod p(p-1)) mod p^2, same for q^2
+  ZZ x = conv<ZZ>(r);
+  ZZ xp, xq;
+  PowerMod(xp, x % p2, np, p2);
+  PowerMod(xq, x % q2, nq, q2);
+  return conv<ZZ_p>(crtN2(xp, xq));
+}
+
 ZZ_p PaillierEncryption::pickRandom()
 {
   // 0 < r < N, gcd(r, n) = 1
@@ -212,26 +376,179 @@ ZZ_p PaillierEncryption::pickRandom()
       return r;
   }
 }
+
+void PaillierEncryption::sampleRandom(ZZ_p &r, ZZ_p &rn)
+{
+  if (shortExpBits == 0)
+  {
+    r = pickRandom();
+    rn = powerN(r);
+    return;
+  }
+
+  // r = r0^a mod n, r^n = (r0^n)^a = h^a mod n^2
+  ZZ a = RandomBits_ZZ(shortExpBits);
+  {
+    ZZ_pPush push(n);
+    conv(r, r0Table.power(a));
+  }
+  {
+    ZZ_pPush push(n2);
+    conv(rn, hTable.power(a));
+  }
+}
+
+void PaillierEncryption::pickRandom(ZZ_p &r, ZZ_p &rn)
+{
+  if (pool != nullptr && pool->take(r, rn))
+    return;
+
+  sampleRandom(r, rn);
+}
+
+void PaillierEncryption::attachPool(size_t depth, size_t threads)
+{
+  detachPool();
+  pool = make_shared<RandomnessPool>([this](ZZ_p &r, ZZ_p &rn) {
+    sampleRandom(r, rn);
+  }, depth, threads);
+}
+
+void PaillierEncryption::detachPool()
+{
+  if (pool == nullptr)
+    return;
+
+  pool->stop();
+  pool = nullptr;
+}
+
+void PaillierEncryption::enableShortExponent(long bits, const ZZ_p &_r0)
+{
+  // the exponent is guessed in about 2^(bits / 2) steps
+  if (bits < MIN_SHORT_EXPONENT_BITS)
+    throw invalid_argument("exponent length must be at least " + to_string(MIN_SHORT_EXPONENT_BITS) + " bits");
+
+  // the pool workers read the tables
+  if (pool != nullptr)
+    pool->stop();
+
+  ZZ base = _r0 != 0 ? rep(_r0) : rep(pickRandom());
+  if (GCD(base, n) != 1)
+    throw invalid_argument("r0 must be coprime to n");
+
+  {
+    ZZ_pPush push(n);
+    conv(r0, base);
+  }
+  r0Table = FixedBase(base, n, bits);
+  {
+    ZZ_pPush push(n2);
+    hTable = FixedBase(rep(powerN(conv<ZZ_p>(base))), n2, bits);
+  }
+  shortExpBits = bits;
+
+  if (pool != nullptr)
+    pool->start();
+}
+
+void PaillierEncryption::disableShortExponent()
+{
+  if (pool != nullptr)
+    pool->stop();
+
+  shortExpBits = 0;
+  r0Table = FixedBase();
+  hTable = FixedBase();
+
+  if (pool != nullptr)
+    pool->start();
+}
+
 ZZ_p PaillierEncryption::encrypt(const ZZ &m)
 {
-  ZZ_pPush push(Q);
-  return encrypt(m, ZZ_p());
+  ZZ_p r;
+  return encrypt(m, &r);
+}
+
+ZZ_p PaillierEncryption::encrypt(const ZZ &m, ZZ_p *r)
+{
+  ZZ_p rn;
+  pickRandom(*r, rn);
+  return encrypt(m, *r, rn);
 }
 
 ZZ_p PaillierEncryption::encrypt(const ZZ &m, const ZZ_p &_r)
+{
+  if (_r == 0)
+    return encrypt(m);
+
+  return encrypt(m, _r, powerN(_r));
+}
+
+ZZ_p PaillierEncryption::encrypt(const ZZ &m, const ZZ_p &r, const ZZ_p &rn)
 {
   // c = g^m      * r^n mod n^2
   // c = (n+1)^m  * r^b mod n^2
   // c = (nm + 1) * r^n mod n^2
   ZZ_pPush push(n2);
 
-  ZZ_p r = _r != 0 ? _r : pickRandom();
-  ZZ_p c = conv<ZZ_p>(n * m + 1) * power(r, n);
+  ZZ_p c = conv<ZZ_p>(n * m + 1) * rn;
   return c;
 }
 
+void PaillierEncryption::encryptBatch(const Vec<ZZ> &ms, Vec<ZZ_p> &cs, Vec<ZZ_p> &rs, size_t threads)
+{
+  cs.SetLength(ms.length());
+  rs.SetLength(ms.length());
+
+  // index i samples from the stream seeded by (seed, i)
+  ZZ seed = RandomBits_ZZ(256) << 64;
+
+  Parallel::forRange(ms.length(), [&](size_t begin, size_t end) {
+    RandomStreamPush push;
+    ZZ_p rn;
+    for (size_t i = begin; i < end; i++)
+    {
+      if (pool == nullptr || !pool->take(rs[i], rn))
+      {
+        SetSeed(seed + i);
+        sampleRandom(rs[i], rn);
+      }
+      cs[i] = encrypt(ms[i], rs[i], rn);
+    }
+  }, threads);
+}
+
+ZZ PaillierEncryption::decryptPrime(const ZZ &c, const ZZ &pi, const ZZ &pi2, const ZZ &hi)
+{
+  // m_i = L_i(c^(pi-1) mod pi^2) * hi mod pi
+  ZZ x;
+  PowerMod(x, c % pi2, pi - 1, pi2);
+
+  ZZ l;
+  div(l, x - 1, pi);
+  MulMod(l, l, hi, pi);
+  return l;
+}
+
 ZZ PaillierEncryption::decrypt(const ZZ_p &c)
 {
+  // CRT, half-size exponent and modulus for each prime
+  // m = m_p + p * ((m_q - m_p) * p^-1 mod q)
+  if (isKeyHolder())
+  {
+    ZZ x = conv<ZZ>(c);
+    ZZ mp = decryptPrime(x, p, p2, hp);
+    ZZ mq = decryptPrime(x, q, q2, hq);
+
+    ZZ t;
+    sub(t, mq, mp);
+    rem(t, t, q);
+    MulMod(t, t, pInvQ, q);
+    return mp + p * t;
+  }
+
   // L(x) = (x-1) / n
   // m = L(c^lambda mod n^2) * mu mod n
   ZZ_pPush push(n2);
@@ -245,6 +562,20 @@ ZZ PaillierEncryption::decrypt(const ZZ_p &c)
   return conv<ZZ>(m);
 }
 
+Vec<ZZ> PaillierEncryption::decryptBatch(const Vec<ZZ_p> &cs, size_t threads)
+{
+  Vec<ZZ> ret;
+  ret.SetLength(cs.length());
+
+  Parallel::forRange(cs.length(), [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      ret[i] = decrypt(cs[i]);
+    }
+  }, threads);
+  return ret;
+}
+
 ZZ_p PaillierEncryption::add(const ZZ_p &c, const ZZ &m)
 {
   auto c2 = encrypt(m);
@@ -262,6 +593,29 @@ ZZ_p PaillierEncryption::add(const ZZ_p &c1, const ZZ_p &c2)
   return c1 * c2;
 }
 
+ZZ_p PaillierEncryption::addPlain(const ZZ_p &c, const ZZ &m)
+{
+  // g^m = (n+1)^m = 1 + nm mod n^2
+  ZZ_pPush push(n2);
+  return c * conv<ZZ_p>(n * m + 1);
+}
+
+ZZ_p PaillierEncryption::linearCombination(const Vec<ZZ_p> &cs, const Vec<ZZ> &ws, size_t threads)
+{
+  if (cs.length() != ws.length())
+    throw invalid_argument("number of ciphertexts and weights do not match");
+
+  Vec<ZZ> exps = ws;
+  for (long i = 0; i < exps.length(); i++)
+  {
+    if (exps[i] < 0)
+      rem(exps[i], exps[i], n);
+  }
+
+  ZZ_pPush push(n2);
+  return MultiExp::power(cs, exps, threads);
+}
+
 ZZ_p PaillierEncryption::mul(const ZZ_p &c, const ZZ &k)
 {
   ZZ_pPush push(n2);
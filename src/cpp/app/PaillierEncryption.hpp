@@ -2,6 +2,11 @@
 
 #include "./namespace.hpp"
 
+#include "./RandomnessPool.hpp"
+#include "./math/FixedBase.hpp"
+#include "./math/MultiExp.hpp"
+#include "./utils/Parallel.hpp"
+
 #include "NTL/ZZ.h"
 #include "NTL/ZZ_p.h"
 #include "NTL/vector.h"
@@ -9,6 +14,9 @@
 namespace polyu
 {
 
+/// @brief Key generation progress callback with the stage ("p", "q", "Q" or "G") and the number of candidates tested, return false to cancel
+typedef function<bool(const string &stage, size_t count)> KeyGenCallback;
+
 /**
  * @brief _PaillierEncryption_ represents the paillier group elements with at least a public key or a public-key-private-key pair. Depends on the value it has, it is used in encryption, decryption, commitment and zero-knowledge(ZKP) prove protocols. Also, there are some static function for you to generate a new key pair and find the generator in the group.
  */
@@ -18,9 +26,27 @@ class PaillierEncryption
 private:
   ZZ f; // random f such that Q = (f * n2) + 1 is prime
 
+  size_t threads = 0;                // thread budget of key generation, 0 means default
+  KeyGenCallback callback = nullptr; // key generation progress callback
+  bool cancelled = false;            // key generation is cancelled
+  mutex notifyLock;                  // callbacks of this instance are called one at a time
+
   void init(bool skipGenerate = false); // init value n2, g, mu
 
+  void notify(const string &stage, size_t count); // report progress, throw if cancelled
+
+  ZZ genPrime(long length, const ZZ &seed, const string &stage); // random prime from its own random stream
+
+  ZZ searchGroupFactor(); // smallest f >= 2 such that Q = (f * n2) + 1 is prime
+
+  ZZ decryptPrime(const ZZ &c, const ZZ &pi, const ZZ &pi2, const ZZ &hi); // m mod pi, CRT component
+
+  void sampleRandom(ZZ_p &r, ZZ_p &rn); // fresh (r, r^n) without the pool
+
 public:
+  /// @brief Minimum length of the short random exponent, twice the 128-bit security level
+  static const long MIN_SHORT_EXPONENT_BITS = 256;
+
   /*
    * Keypair
    */
@@ -42,6 +68,33 @@ public:
   /// @brief Internal value(g), g = (n+1) mod n^2
   ZZ_p g;
 
+  /*
+   * CRT parameters, only available with private elements
+   */
+  /// @brief Internal value(p2), p2 = p^2
+  ZZ p2;
+
+  /// @brief Internal value(q2), q2 = q^2
+  ZZ q2;
+
+  /// @brief Internal value(hp), hp = L_p(g^(p-1) mod p^2)^-1 mod p
+  ZZ hp;
+
+  /// @brief Internal value(hq), hq = L_q(g^(q-1) mod q^2)^-1 mod q
+  ZZ hq;
+
+  /// @brief Internal value(pInvQ), pInvQ = p^-1 mod q
+  ZZ pInvQ;
+
+  /// @brief Internal value(np), np = n mod p(p-1), reduced exponent of r^n mod p^2
+  ZZ np;
+
+  /// @brief Internal value(nq), nq = n mod q(q-1), reduced exponent of r^n mod q^2
+  ZZ nq;
+
+  /// @brief Internal value(p2InvQ2), p2InvQ2 = (p^2)^-1 mod q^2
+  ZZ p2InvQ2;
+
   /*
    * Cyclic group parameters
    */
@@ -54,6 +107,24 @@ public:
   /// @brief Group generator
   ZZ_p G;
 
+  /*
+   * Short exponent mode, r = r0^a mod n, r^n = h^a mod n^2
+   */
+  /// @brief Length of the random exponent (a), 0 if short exponent mode is disabled
+  long shortExpBits = 0;
+
+  /// @brief Public randomness base (r0)
+  ZZ_p r0;
+
+  /// @brief Fixed base table of r0 mod n
+  FixedBase r0Table;
+
+  /// @brief Fixed base table of h = r0^n mod n^2
+  FixedBase hTable;
+
+  /// @brief Pool of precomputed randomness pairs (r, r^n), nullptr if not attached
+  shared_ptr<RandomnessPool> pool = nullptr;
+
   /**
    * @brief Generate a new Keypair
    *
@@ -69,6 +140,16 @@ public:
    */
   PaillierEncryption(size_t byteLength, const binary_t &seed);
 
+  /**
+   * @brief Generate a new Keypair with Seed, p and q are searched concurrently and the group element Q is searched by several threads. The result only depends on the seed
+   *
+   * @param byteLength Key length
+   * @param seed Seed
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @param callback Progress callback, return false to cancel the generation with runtime_error
+   */
+  PaillierEncryption(size_t byteLength, const binary_t &seed, size_t threads, const KeyGenCallback &callback = nullptr);
+
   /**
    * @brief Import KeyPair from N (public key) and group elements, can perform encrypt
    *
@@ -100,6 +181,12 @@ public:
    */
   PaillierEncryption(const ZZ &N, const ZZ &p, const ZZ &q);
 
+  ~PaillierEncryption();
+
+  // the randomness pool refers to this instance
+  PaillierEncryption(const PaillierEncryption &) = delete;
+  PaillierEncryption &operator=(const PaillierEncryption &) = delete;
+
   /**
    * @brief Generate a generator under the paillier group
    *
@@ -115,6 +202,25 @@ public:
    */
   Vec<ZZ_p> genGenerators(size_t n);
 
+  /**
+   * @brief Derive a generator under the paillier group from a public seed and an index, the result does not depend on the caller's random stream
+   *
+   * @param seed Public seed
+   * @param index Generator index
+   * @return ZZ_p
+   */
+  ZZ_p genGenerator(const ZZ &seed, size_t index);
+
+  /**
+   * @brief Derive N generators under the paillier group concurrently, the i-th generator is genGenerator(seed, i)
+   *
+   * @param n Number of generators needed
+   * @param seed Public seed
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return Vec<ZZ_p>
+   */
+  Vec<ZZ_p> genGenerators(size_t n, const ZZ &seed, size_t threads = 0);
+
   /**
    * @brief Get the private element (p)
    *
@@ -157,6 +263,31 @@ public:
    */
   ZZ_p getGroupG();
 
+  /**
+   * @brief Check if the private elements (p, q) are available, the key holder uses CRT for encryption and decryption
+   *
+   * @return true
+   * @return false
+   */
+  bool isKeyHolder();
+
+  /**
+   * @brief Combine residues modulo p^2 and q^2 to a value modulo n^2, key holder only
+   *
+   * @param xp x mod p^2
+   * @param xq x mod q^2
+   * @return ZZ x mod n^2
+   */
+  ZZ crtN2(const ZZ &xp, const ZZ &xq);
+
+  /**
+   * @brief Calculate r^n mod n^2, the key holder computes it by CRT with reduced exponents
+   *
+   * @param r Randomness, gcd(r, n) = 1
+   * @return ZZ_p r^n mod n^2
+   */
+  ZZ_p powerN(const ZZ_p &r);
+
   /**
    * @brief Pick randomness (r) for encryption under public key (N), such that 0 < r < N, gcd(r, n) = 1
    *
@@ -165,13 +296,56 @@ public:
   ZZ_p pickRandom();
 
   /**
-   * @brief Encrypt a message
+   * @brief Pick randomness (r) with precomputed r^n mod n^2, taken from the randomness pool if it is attached and not empty
+   *
+   * @param r Randomness (r)
+   * @param rn r^n mod n^2
+   */
+  void pickRandom(ZZ_p &r, ZZ_p &rn);
+
+  /**
+   * @brief Attach a randomness pool, background threads keep (r, r^n) pairs ready for encryption
+   *
+   * @param depth Number of pairs to keep ready
+   * @param threads Number of background threads, 0 means no background refill
+   */
+  void attachPool(size_t depth, size_t threads = 1);
+
+  /**
+   * @brief Stop and detach the randomness pool
+   */
+  void detachPool();
+
+  /**
+   * @brief Enable short exponent mode, fresh randomness is sampled as r = r0^a mod n with a short random exponent (a), so r^n = h^a mod n^2 is computed from fixed base tables
+   *
+   * @param bits Length of the random exponent (a), at least MIN_SHORT_EXPONENT_BITS
+   * @param r0 Public randomness base, gcd(r0, n) = 1, 0 means pick a new one
+   */
+  void enableShortExponent(long bits = 256, const ZZ_p &r0 = ZZ_p());
+
+  /**
+   * @brief Disable short exponent mode, fresh randomness is sampled uniformly again
+   */
+  void disableShortExponent();
+
+  /**
+   * @brief Encrypt a message, the randomness is taken from the randomness pool if it is attached and not empty
    *
    * @param m Original message
    * @return ZZ_p Ciphertext (c), the encrypted result
    */
   ZZ_p encrypt(const ZZ &m);
 
+  /**
+   * @brief Encrypt a message and return the randomness, eg. as the witness of _CEnc_. The randomness is taken from the randomness pool if it is attached and not empty
+   *
+   * @param m Original message
+   * @param r Output, the randomness used
+   * @return ZZ_p Ciphertext (c), the encrypted result
+   */
+  ZZ_p encrypt(const ZZ &m, ZZ_p *r);
+
   /**
    * @brief Encrypt a message
    *
@@ -181,6 +355,26 @@ public:
    */
   ZZ_p encrypt(const ZZ &m, const ZZ_p &r);
 
+  /**
+   * @brief Encrypt a message with precomputed randomness, takes one modular multiplication
+   *
+   * @param m Original message
+   * @param r Randomness
+   * @param rn r^n mod n^2
+   * @return ZZ_p Ciphertext (c), the encrypted result
+   */
+  ZZ_p encrypt(const ZZ &m, const ZZ_p &r, const ZZ_p &rn);
+
+  /**
+   * @brief Encrypt a list of messages concurrently. Fresh randomness is taken from the pool if attached, otherwise each index samples from its own random stream derived from the caller's one, so the result does not depend on the thread count
+   *
+   * @param ms Original messages
+   * @param cs Ciphertexts (c), the encrypted results
+   * @param rs Randomness used by each encryption
+   * @param threads Number of threads, 0 means use the default thread budget
+   */
+  void encryptBatch(const Vec<ZZ> &ms, Vec<ZZ_p> &cs, Vec<ZZ_p> &rs, size_t threads = 0);
+
   /**
    * @brief Decrypt a ciphertext
    *
@@ -189,6 +383,15 @@ public:
    */
   ZZ decrypt(const ZZ_p &c);
 
+  /**
+   * @brief Decrypt a list of ciphertexts concurrently
+   *
+   * @param cs Ciphertexts (c)
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return Vec<ZZ> Original messages (m)
+   */
+  Vec<ZZ> decryptBatch(const Vec<ZZ_p> &cs, size_t threads = 0);
+
   /**
    * @brief Homomorphic addition, m1 + m2 = Dec(c1 + c2)
    *
@@ -216,6 +419,25 @@ public:
    */
   ZZ_p add(const ZZ_p &c1, const ZZ_p &c2);
 
+  /**
+   * @brief Homomorphic addition of a plaintext without re-randomization, m1 + m2 = Dec(c1 * (1 + n * m2))
+   *
+   * @param c1 Ciphertext 1
+   * @param m2 Original message 2
+   * @return ZZ_p c1 + m2
+   */
+  ZZ_p addPlain(const ZZ_p &c1, const ZZ &m2);
+
+  /**
+   * @brief Homomorphic weighted sum, sum(ms[i] * ws[i]) = Dec(prod(cs[i]^ws[i])), computed by one multi-exponentiation
+   *
+   * @param cs Ciphertexts
+   * @param ws Weights, negative weights are reduced mod n
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return ZZ_p
+   */
+  ZZ_p linearCombination(const Vec<ZZ_p> &cs, const Vec<ZZ> &ws, size_t threads = 0);
+
   // E(c)^k = c * k
   /**
    * @brief Homomorphic multiplication, m * k = Dec(c * k)
@@ -0,0 +1,121 @@
+#include "./ParamBundle.hpp"
+
+namespace
+{
+const string MAGIC = "ZKPPARAM";
+const string NAME = "parameter bundle";
+} // namespace
+
+void ParamBundle::save(const string &path, const shared_ptr<PaillierEncryption> &crypto, const Vec<ZZ_p> &gi, const vector<FixedBase> &tables)
+{
+  vector<SectionFile::Content> contents;
+  Vec<ZZ> values;
+
+  values.SetLength(1);
+  values[0] = crypto->getPublicKey();
+  contents.push_back(SectionFile::encode(SECTION_N, values));
+  values[0] = crypto->getGroupQ();
+  contents.push_back(SectionFile::encode(SECTION_Q, values));
+  values[0] = crypto->getGroupP();
+  contents.push_back(SectionFile::encode(SECTION_N2, values));
+  values[0] = rep(crypto->getGroupG());
+  contents.push_back(SectionFile::encode(SECTION_G, values));
+
+  ConvertUtils::toVecZZ(gi, values);
+  contents.push_back(SectionFile::encode(SECTION_GI, values));
+
+  // table section: [base, modulus, table...]
+  for (auto &t : tables)
+  {
+    Vec<ZZ> tbl;
+    t.toVec(tbl);
+    values.SetLength(2);
+    values[0] = t.base;
+    values[1] = t.modulus;
+    values.append(tbl);
+    contents.push_back(SectionFile::encode(SECTION_TABLE, values, t.window, t.maxBits));
+  }
+
+  SectionFile::write(path, MAGIC, VERSION, contents, NAME);
+}
+
+ParamBundle::ParamBundle(const string &path) : file(path, MAGIC, VERSION, NAME)
+{
+  file.section(SECTION_N);
+  file.section(SECTION_Q);
+  file.section(SECTION_N2);
+  file.section(SECTION_G);
+  file.section(SECTION_GI);
+}
+
+bool ParamBundle::verifyData() const
+{
+  return file.verifyData();
+}
+
+ZZ ParamBundle::getPublicKey() const
+{
+  return file.element(file.section(SECTION_N), 0);
+}
+
+ZZ ParamBundle::getGroupQ() const
+{
+  return file.element(file.section(SECTION_Q), 0);
+}
+
+ZZ ParamBundle::getGroupP() const
+{
+  return file.element(file.section(SECTION_N2), 0);
+}
+
+ZZ_p ParamBundle::getGroupG() const
+{
+  ZZ_pPush push(getGroupQ());
+  return conv<ZZ_p>(file.element(file.section(SECTION_G), 0));
+}
+
+size_t ParamBundle::generatorCount() const
+{
+  return file.section(SECTION_GI).count;
+}
+
+Vec<ZZ_p> ParamBundle::getGenerators(size_t n) const
+{
+  auto &s = file.section(SECTION_GI);
+  if (n == 0)
+    n = s.count;
+  if (n > s.count)
+    throw invalid_argument("not enough generators in parameter bundle");
+
+  ZZ_pPush push(getGroupQ());
+  Vec<ZZ_p> ret;
+  ret.SetLength(n);
+  for (size_t i = 0; i < n; i++)
+    conv(ret[i], file.element(s, i));
+  return ret;
+}
+
+size_t ParamBundle::tableCount() const
+{
+  return file.sectionCount(SECTION_TABLE);
+}
+
+FixedBase ParamBundle::getTable(size_t index) const
+{
+  auto &s = file.section(SECTION_TABLE, index);
+  if (s.count < 2)
+    throw invalid_argument("invalid fixed base table in parameter bundle");
+
+  Vec<ZZ> tbl;
+  tbl.SetLength(s.count - 2);
+  for (size_t i = 2; i < s.count; i++)
+    tbl[i - 2] = file.element(s, i);
+  return FixedBase(file.element(s, 0), file.element(s, 1), s.maxBits, s.window, tbl);
+}
+
+shared_ptr<PaillierEncryption> ParamBundle::toEncryption() const
+{
+  auto GP_P = getGroupP();
+  auto GP_G = getGroupG();
+  return make_shared<PaillierEncryption>(getPublicKey(), getGroupQ(), GP_P, GP_G);
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "./namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+
+#include "./PaillierEncryption.hpp"
+#include "./math/FixedBase.hpp"
+#include "./utils/ConvertUtils.hpp"
+#include "./utils/SectionFile.hpp"
+
+namespace polyu
+{
+
+/**
+ * @brief _ParamBundle_ is a read-only view of a binary parameter bundle file, which holds the public group parameters (N, Q, N^2, G), the commitment generators gi and optional fixed base tables. The file is mapped into memory and each element is decoded on access, so processes start without regenerating the parameters and share the pages. It is a _SectionFile_ with magic "ZKPPARAM".
+ */
+class ParamBundle
+{
+private:
+  SectionFile file;
+
+public:
+  static const uint32_t VERSION = 1;
+
+  static const uint32_t SECTION_N = 1;
+  static const uint32_t SECTION_Q = 2;
+  static const uint32_t SECTION_N2 = 3;
+  static const uint32_t SECTION_G = 4;
+  static const uint32_t SECTION_GI = 5;
+  static const uint32_t SECTION_TABLE = 6;
+
+  /**
+   * @brief Map a parameter bundle file, the header checksum and the section bounds are validated
+   *
+   * @param path File path
+   */
+  ParamBundle(const string &path);
+
+  ParamBundle(const ParamBundle &) = delete;
+  ParamBundle &operator=(const ParamBundle &) = delete;
+
+  /**
+   * @brief Write the public parameters to a bundle file, the private elements are never written
+   *
+   * @param path File path
+   * @param crypto PaillierEncryption object, defined the group elements
+   * @param gi Commitment generators
+   * @param tables Optional fixed base tables
+   */
+  static void save(const string &path, const shared_ptr<PaillierEncryption> &crypto, const Vec<ZZ_p> &gi, const vector<FixedBase> &tables = vector<FixedBase>());
+
+  /**
+   * @brief Check the data checksum of every section, it reads the whole file
+   *
+   * @return true
+   * @return false
+   */
+  bool verifyData() const;
+
+  /**
+   * @brief Get the public key
+   *
+   * @return ZZ
+   */
+  ZZ getPublicKey() const;
+
+  /**
+   * @brief Get the group element Q
+   *
+   * @return ZZ
+   */
+  ZZ getGroupQ() const;
+
+  /**
+   * @brief Get the group element p
+   *
+   * @return ZZ
+   */
+  ZZ getGroupP() const;
+
+  /**
+   * @brief Get the group generator g
+   *
+   * @return ZZ_p Group generator, under modulus Q
+   */
+  ZZ_p getGroupG() const;
+
+  /**
+   * @brief Number of commitment generators in the bundle
+   *
+   * @return size_t
+   */
+  size_t generatorCount() const;
+
+  /**
+   * @brief Get the first n commitment generators
+   *
+   * @param n Number of generators, 0 means all
+   * @return Vec<ZZ_p> Generators, under modulus Q
+   */
+  Vec<ZZ_p> getGenerators(size_t n = 0) const;
+
+  /**
+   * @brief Number of fixed base tables in the bundle
+   *
+   * @return size_t
+   */
+  size_t tableCount() const;
+
+  /**
+   * @brief Load a fixed base table
+   *
+   * @param index Table index
+   * @return FixedBase
+   */
+  FixedBase getTable(size_t index) const;
+
+  /**
+   * @brief Create a public key only PaillierEncryption object from the bundle
+   *
+   * @return shared_ptr<PaillierEncryption>
+   */
+  shared_ptr<PaillierEncryption> toEncryption() const;
+};
+
+} // namespace polyu
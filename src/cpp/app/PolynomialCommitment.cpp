@@ -1,5 +1,7 @@
 #include "./PolynomialCommitment.hpp"
 
+#include <mutex>
+
 PolynomialCommitment::PolynomialCommitment(const shared_ptr<PaillierEncryption> &crypto, size_t n)
     : PolynomialCommitment::PolynomialCommitment(crypto, crypto->genGenerators(n))
 {
@@ -35,6 +37,59 @@ PolynomialCommitment::PolynomialCommitment(const ZZ &Q, const ZZ &p, const ZZ_p
   }
 }
 
+PolynomialCommitment::~PolynomialCommitment()
+{
+  // the pool workers refer to this instance
+  detachPool();
+}
+
+void PolynomialCommitment::sampleBlinding(ZZ_p &r, ZZ_p &gr)
+{
+  r = MathUtils::randZZ_p(p, true);
+
+  ZZ x;
+  if (!tables.empty() && tables[0].base == rep(g))
+    tables[0].power(x, rep(r));
+  else
+    PowerMod(x, rep(g), rep(r), Q);
+
+  ZZ_pPush push(Q);
+  conv(gr, x);
+}
+
+void PolynomialCommitment::pickBlinding(ZZ_p &r, ZZ_p &gr)
+{
+  if (pool != nullptr && pool->take(r, gr))
+    return;
+
+  sampleBlinding(r, gr);
+}
+
+void PolynomialCommitment::pickBlinding(size_t count, Vec<ZZ_p> &rs, Vec<ZZ_p> &grs)
+{
+  rs.SetLength(count);
+  grs.SetLength(count);
+  for (size_t i = 0; i < count; i++)
+    pickBlinding(rs[i], grs[i]);
+}
+
+void PolynomialCommitment::attachPool(size_t depth, size_t threads)
+{
+  detachPool();
+  pool = make_shared<RandomnessPool>([this](ZZ_p &r, ZZ_p &gr) {
+    sampleBlinding(r, gr);
+  }, depth, threads);
+}
+
+void PolynomialCommitment::detachPool()
+{
+  if (pool == nullptr)
+    return;
+
+  pool->stop();
+  pool = nullptr;
+}
+
 // original version
 // ZZ_p PolynomialCommitment::commit(const Vec<ZZ_p> &mi, const ZZ_p &r)
 // {
@@ -51,104 +106,288 @@ PolynomialCommitment::PolynomialCommitment(const ZZ &Q, const ZZ &p, const ZZ_p
 //   return ret;
 // }
 
- // allen's version
+bool PolynomialCommitment::isIdentity(const ZZ_p &x) const
+{
+  ZZ f, y;
+  div(f, Q - 1, p);
+  PowerMod(y, rep(x), f, Q);
+  return IsOne(y);
+}
+
 ZZ_p PolynomialCommitment::commit(const Vec<ZZ_p> &mi, const ZZ_p &r)
 {
-  //unsigned short bitlength = r.ModulusSize();
-  
-  //cout << "is this correct bitlength?:" << p.size() << endl; 
-  //cout << "is this correct Q length?:" << Q.size() << endl; 
-
-  Vec<ZZ> zmi; 
-  zmi.SetLength(mi.length());
-  conv(zmi,mi);
-  
-  unsigned long bitlength = NumBits(zmi[0]);
-  for (int i=0;i<mi.length();i++) {
- //   cout << "zmi[" << i << "]=" << zmi[i] << endl;
- //   cout << "mi[" << i << "]=" << mi[i] << endl; 
- //   cout << "numBits:" << NumBits(zmi[i]) << endl;
-    if (bitlength < NumBits(zmi[i]))
-      bitlength = NumBits(zmi[i]); 
+  return commit(mi, r, threads);
+}
+
+size_t PolynomialCommitment::tableBytes(size_t count, long window) const
+{
+  if (count == 0)
+    return 0;
+  if (window <= 0)
+    window = 4;
+
+  // g takes the randomness, exponents are reduced by p; gi only take short exponents
+  size_t full = (NumBits(p) + window - 1) / window;
+  size_t small = (CompactMat::SMALL_BITS + window - 1) / window;
+  return (full + (count - 1) * small) * ((1L << window) - 1) * NumBytes(Q);
+}
+
+size_t PolynomialCommitment::precompute(size_t memoryBudget, long window)
+{
+  // the pool workers read the tables
+  if (pool != nullptr)
+    pool->stop();
+
+  size_t count = 0;
+  if (memoryBudget >= tableBytes(1, window))
+  {
+    size_t extra = (memoryBudget - tableBytes(1, window)) / (tableBytes(2, window) - tableBytes(1, window));
+    count = 1 + min<size_t>(gi.length(), extra);
   }
-//  cout << "real BitLength" << bitlength << endl;
+  tables.clear();
+  tables.resize(count);
+
+  Parallel::forRange(count, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      if (i == 0)
+        tables[i] = FixedBase(rep(g), Q, NumBits(p), window);
+      else
+        tables[i] = FixedBase(rep(gi[i - 1]), Q, CompactMat::SMALL_BITS, window);
+    }
+  }, threads);
 
-  ZZ_pPush push(Q);
+  if (pool != nullptr)
+    pool->start();
+  return count;
+}
 
-  ZZ_p gx;
-  ZZ_p ret = power(g, conv<ZZ>(r));
+size_t PolynomialCommitment::setTables(const vector<FixedBase> &tables)
+{
+  if (pool != nullptr)
+    pool->stop();
 
-  
+  this->tables.clear();
+  for (size_t i = 0; i < tables.size() && i <= (size_t)gi.length(); i++)
+  {
+    auto &base = i == 0 ? g : gi[i - 1];
+    if (tables[i].modulus != Q || tables[i].base != rep(base))
+      break;
+    this->tables.push_back(tables[i]);
+  }
 
+  if (pool != nullptr)
+    pool->start();
+  return this->tables.size();
+}
 
-  const unsigned int bucket_size = 256; // see below. the 4.0 depends on the bucket_size. the number should be log bucket_size
- 
-  unsigned long round = ceil(bitlength/8.0); //1024-bit exponent, 4-bit bucket => 256 rounds 
-  // has to tune the 4.0 to represent the bucket size of 16
-  
-  ZZ pow = conv<ZZ>(1);
-  unsigned long shift = 0;
-  unsigned long d = 1;
+const vector<FixedBase> &PolynomialCommitment::getTables() const
+{
+  return tables;
+}
 
-  for (unsigned int j = 0; j < round; j++ ) {
-   // cout << "====Round: " << j <<"===="<< endl;
-    ZZ_p S[bucket_size]; 
-    ZZ_p T[bucket_size]; 
-    for (unsigned int k=0; k<bucket_size;k++) {
-      S[k]=conv<ZZ_p>(1);
-      T[k]=conv<ZZ_p>(1);
-    }
-    
-    long t = 0;
-    ZZ flag = ConvertUtils::hexToZZ("FF");
-    ZZ tmp;
-    
-    for (unsigned int i =0; i < zmi.length(); i++ ) {
-      NTL::bit_and(tmp, zmi[i] >> shift, flag);
-      t = conv<int>(tmp);
-   //   cout << "zmi[i]" << zmi[i] << "|t:" << t << endl;
-      if (t!=0)
-        mul(S[t], S[t], gi[i]);
+void PolynomialCommitment::messageExps(const Vec<ZZ_p> &mi, Vec<ZZ> &exps)
+{
+  if (mi.length() > gi.length())
+    throw invalid_argument("message length exceeds the number of generators");
+
+  // values close to p are taken as small negative exponents
+  exps.SetLength(mi.length() + 1);
+  clear(exps[0]);
+  for (long i = 0; i < mi.length(); i++)
+  {
+    auto &e = rep(mi[i]);
+    if (NumBits(e) <= CompactMat::SMALL_BITS)
+    {
+      exps[i + 1] = e;
+      continue;
     }
-    //list bucket:
-   // for (int i=0;i<bucket_size;i++) {
-   //   cout << "i=" << i << ":" << S[i] << "|";
-   // }
-
-    shift = shift + 8;
-    T[bucket_size-1] = S[bucket_size-1];
-    for (unsigned int i=bucket_size-1; i>1; i--) {
-      mul (T[i-1], T[i], S[i-1]);
+
+    sub(exps[i + 1], p, e);
+    if (NumBits(exps[i + 1]) <= CompactMat::SMALL_BITS)
+      exps[i + 1] = -exps[i + 1];
+    else
+      exps[i + 1] = e;
+  }
+}
+
+ZZ_p PolynomialCommitment::commit(const Vec<ZZ_p> &mi, const ZZ_p &r, size_t threads)
+{
+  // c = g^r * Product(gi ^ mi)
+  Vec<ZZ> exps;
+  messageExps(mi, exps);
+  exps[0] = rep(r);
+  return commitExps(exps, threads);
+}
+
+ZZ_p PolynomialCommitment::commitBlinded(const Vec<ZZ_p> &mi, const ZZ_p &gr, size_t threads)
+{
+  // c = g^r * Product(gi ^ mi), g^r is precomputed
+  Vec<ZZ> exps;
+  messageExps(mi, exps);
+  auto ret = commitExps(exps, threads);
+
+  ZZ_pPush push(Q);
+  return ret * gr;
+}
+
+ZZ_p PolynomialCommitment::commitExps(const Vec<ZZ> &exps, size_t threads, const Vec<ZZ_p> &extra, const Vec<ZZ> &extraExps)
+{
+  if (extra.length() != extraExps.length())
+    throw invalid_argument("extra bases and exponents count mismatch");
+
+  struct Term
+  {
+    size_t index;
+    ZZ exp;
+    bool negative;
+  };
+
+  // leading bases with a table, gi may be replaced after the tables are built
+  size_t count = exps.length();
+  size_t fixed = 0;
+  while (fixed < tables.size() && fixed < count &&
+         tables[fixed].base == rep(fixed == 0 ? g : gi[fixed - 1]))
+    fixed++;
+
+  // acc[0] for positive exponents, acc[1] for negative exponents
+  ZZ acc[2] = {ZZ(1), ZZ(1)};
+  vector<Term> tabled;
+  Vec<ZZ> bases[3], rest[3]; // small positive, small negative, full width
+
+  size_t total = count + extra.length();
+  for (size_t i = 0; i < total; i++)
+  {
+    auto &x = i < count ? exps[i] : extraExps[i - count];
+    if (IsZero(x))
+      continue;
+    if (i >= count && sign(x) < 0)
+      throw invalid_argument("exponents of extra bases must be non-negative");
+
+    auto &base = rep(i == 0 ? g : i < count ? gi[i - 1] : extra[i - count]);
+    bool negative = sign(x) < 0;
+    ZZ e = abs(x);
+    if (negative && NumBits(e) > CompactMat::SMALL_BITS)
+    {
+      sub(e, p, e);
+      negative = false;
     }
 
-    ZZ_p R = conv<ZZ_p>(1);
-    for (unsigned int i = 1; i < bucket_size; i++) {
-      mul(R, R, T[i]);      
+    // a table costs one multiplication per window, full width exponents of gi are
+    // cheaper in the shared Pippenger buckets
+    if (IsOne(e))
+      MulMod(acc[negative], acc[negative], base, Q);
+    else if (i < fixed && NumBits(e) <= tables[i].maxBits && (i == 0 || NumBits(e) <= CompactMat::SMALL_BITS))
+      tabled.push_back({i, e, negative});
+    else
+    {
+      size_t k = NumBits(e) > CompactMat::SMALL_BITS ? 2 : negative;
+      bases[k].append(base);
+      rest[k].append(e);
     }
-    
-
-    //cout << "Round:" << j << "Power:" << pow << endl;
-   power(R, R, pow);
-   mul(pow, pow, bucket_size);
-    
-    
-    mul(ret, ret, R);
   }
 
-  return ret;
+  if (!tabled.empty())
+  {
+    mutex lock;
+    Parallel::forRange(tabled.size(), [&](size_t begin, size_t end) {
+      ZZ partial[2] = {ZZ(1), ZZ(1)};
+      ZZ x;
+      for (size_t k = begin; k < end; k++)
+      {
+        auto &t = tabled[k];
+        tables[t.index].power(x, t.exp);
+        MulMod(partial[t.negative], partial[t.negative], x, Q);
+      }
+      lock_guard<mutex> guard(lock);
+      MulMod(acc[0], acc[0], partial[0], Q);
+      MulMod(acc[1], acc[1], partial[1], Q);
+    }, threads);
+  }
+
+  ZZ x;
+  for (size_t k = 0; k < 3; k++)
+  {
+    if (bases[k].length() == 0)
+      continue;
+    MultiExp::power(x, bases[k], rest[k], Q, threads);
+    MulMod(acc[k == 1], acc[k == 1], x, Q);
+  }
+
+  // the bases have order p, g^-e = (g^e)^-1
+  if (!IsOne(acc[1]))
+  {
+    InvMod(x, acc[1], Q);
+    MulMod(acc[0], acc[0], x, Q);
+  }
+
+  ZZ_pPush push(Q);
+  return conv<ZZ_p>(acc[0]);
 }
 
+void PolynomialCommitment::commitRows(size_t m, const function<ZZ_p(size_t, size_t)> &commitRow, Vec<ZZ_p> &ret)
+{
+  ret.SetLength(m);
+  if (m == 0)
+    return;
+
+  // one thread per row, the rest of the budget is shared by the rows
+  size_t budget = Parallel::threadCount(threads);
+  size_t rowThreads = min(budget, m);
+  size_t innerThreads = max<size_t>(1, budget / m);
+
+  Parallel::forRange(m, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      ret[i] = commitRow(i, innerThreads);
+    }
+  }, rowThreads);
+}
 
 void PolynomialCommitment::commit(const Mat<ZZ_p> &ms, const Vec<ZZ_p> &rs, Vec<ZZ_p> &ret)
 {
-  auto m = ms.NumRows();
-  auto n = ms.NumCols();
+  commitRows(ms.NumRows(), [&](size_t i, size_t threads) {
+    return commit(ms[i], rs[i], threads);
+  }, ret);
+}
 
-  ret.SetLength(m);
-  for (size_t i = 0; i < m; i++)
-  {
-    ret[i] = commit(ms[i], rs[i]);
-  }
+void PolynomialCommitment::commitBlinded(const Mat<ZZ_p> &ms, const Vec<ZZ_p> &grs, Vec<ZZ_p> &ret)
+{
+  commitRows(ms.NumRows(), [&](size_t i, size_t threads) {
+    return commitBlinded(ms[i], grs[i], threads);
+  }, ret);
+}
+
+void PolynomialCommitment::commitBlinded(const CompactMat &ms, const Vec<ZZ_p> &grs, Vec<ZZ_p> &ret)
+{
+  if (ms.NumCols() > gi.length())
+    throw invalid_argument("message length exceeds the number of generators");
+
+  commitRows(ms.NumRows(), [&](size_t i, size_t threads) {
+    Vec<ZZ> exps, row;
+    ms.exponents(i, row);
+    exps.SetLength(1);
+    exps.append(row);
+    auto c = commitExps(exps, threads);
+
+    ZZ_pPush push(Q);
+    return c * grs[i];
+  }, ret);
+}
+
+void PolynomialCommitment::commit(const CompactMat &ms, const Vec<ZZ_p> &rs, Vec<ZZ_p> &ret)
+{
+  if (ms.NumCols() > gi.length())
+    throw invalid_argument("message length exceeds the number of generators");
+
+  commitRows(ms.NumRows(), [&](size_t i, size_t threads) {
+    Vec<ZZ> exps, row;
+    ms.exponents(i, row);
+    exps.SetLength(1);
+    exps[0] = rep(rs[i]);
+    exps.append(row);
+    return commitExps(exps, threads);
+  }, ret);
 }
 
 void PolynomialCommitment::calcT(
@@ -161,27 +400,19 @@ void PolynomialCommitment::calcT(
     throw invalid_argument("m1, m2 must be positive integer");
 
   ZZ_pPush push(p);
-  auto maxDeg = deg(tx);
 
-  // group to m1+m2 x n matrix
+  // group to m1+m2 x n matrix, t_(m1 n) is skipped
   ret.SetDims(m1 + m2 + 1, n);
 
   auto t1Max = m1 * n;
-  auto t2Max = t1Max + m2 * n + 1;
-  size_t i, j;
-  i = j = 0;
-  for (size_t d = 0; d < t1Max && d <= maxDeg; d++)
-  {
-    ret[i][j] = tx[d];
-    ++j == n && (i++);
-    j == n && (j = 0);
-  }
-  for (size_t d = t1Max + 1; d < t2Max && d <= maxDeg; d++)
-  {
-    ret[i][j] = tx[d];
-    ++j == n && (i++);
-    j == n && (j = 0);
-  }
+  Parallel::forRange(m1 + m2, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      size_t d = i < m1 ? i * n : t1Max + 1 + (i - m1) * n;
+      for (size_t j = 0; j < n; j++)
+        ret[i][j] = coeff(tx, d + j);
+    }
+  }, threads);
 
   // Random vector u
   Vec<ZZ_p> u;
@@ -209,16 +440,63 @@ void PolynomialCommitment::commit(
   if (ri.length() != 0 && ri.length() != m)
     throw invalid_argument("ri.size() do not match (m1 + m2 + 1)");
 
-  // Generate randomness if it isn't provided
+  // Pick randomness with precomputed blinding if it isn't provided
   if (IsZero(ri))
   {
-    MathUtils::randVecZZ_p(m, p, ri, true);
+    Vec<ZZ_p> gr;
+    pickBlinding(m, ri, gr);
+    commitBlinded(T, gr, ret);
+    return;
   }
 
   // calculate commitment
   commit(T, ri, ret);
 }
 
+template <typename MulAdd>
+void PolynomialCommitment::evalRows(size_t n, const Vec<ZZ_p> &Z, const Vec<ZZ_p> &ri, const MulAdd &mulAdd, Vec<ZZ_p> &ret)
+{
+  ZZ_pPush push(p);
+
+  // ret = [t_..., r_], t_ = Z * T
+  // each thread owns a range of columns, which are walked in blocks so the
+  // accumulators stay in cache while the rows are streamed, the sums are reduced once
+  const size_t block = 64;
+  size_t m = Z.length();
+  ret.SetLength(n + 1);
+
+  Parallel::forRange(n, [&](size_t begin, size_t end) {
+    Vec<ZZ> acc;
+    acc.SetLength(block);
+    for (size_t b = begin; b < end; b += block)
+    {
+      size_t e = min(end, b + block);
+      for (size_t j = b; j < e; j++)
+        clear(acc[j - b]);
+
+      for (size_t i = 0; i < m; i++)
+      {
+        auto &z = rep(Z[i]);
+        for (size_t j = b; j < e; j++)
+          mulAdd(acc[j - b], z, i, j);
+      }
+
+      for (size_t j = b; j < e; j++)
+      {
+        rem(acc[j - b], acc[j - b], p);
+        conv(ret[j], acc[j - b]);
+      }
+    }
+  }, threads);
+
+  // r_ = Z * r
+  ZZ acc;
+  for (long i = 0; i < ri.length(); i++)
+    MulAddTo(acc, rep(Z[i]), rep(ri[i]));
+  rem(acc, acc, p);
+  conv(ret[n], acc);
+}
+
 void PolynomialCommitment::eval(
     size_t m1, size_t m2, size_t n,
     const Mat<ZZ_p> &T, const Vec<ZZ_p> &ri, const ZZ_p &x,
@@ -230,98 +508,81 @@ void PolynomialCommitment::eval(
   if (ri.length() != 0 && ri.length() != m)
     throw invalid_argument("ri.size() do not match (m1 + m2 + 1)");
 
+  Vec<ZZ_p> Z;
+  evalZ(m1, m2, n, x, Z);
+  evalRows(n, Z, ri, [&](ZZ &acc, const ZZ &z, size_t i, size_t j) {
+    MulAddTo(acc, z, rep(T[i][j]));
+  }, ret);
+}
+
+void PolynomialCommitment::evalZ(size_t m1, size_t m2, size_t n, const ZZ_p &x, Vec<ZZ_p> &Z)
+{
   ZZ_pPush push(p);
 
-  // Compute Z(X)
+  // Z = [x^-(m1 n), ..., x^-n, x, x^(n+1), ..., x^((m2-1)n+1), x^2], one inversion for the negative powers
   auto xn = power(x, n);
-  Vec<ZZ_p> xns;
-  MathUtils::powerVecZZ_p(xn, max(m1 + 1, m2), p, xns);
+  Vec<ZZ_p> xns, xns_;
+  MathUtils::powerVecZZ_p(xn, m2, p, xns);
+  MathUtils::powerVecZZ_p(inv(xn), m1 + 1, p, xns_);
 
-  Vec<ZZ_p> Z;
   Z.SetLength(m1 + m2 + 1);
   for (size_t i = 0; i < m1; i++)
   {
-    inv(Z[i], xns[m1 - i]);
+    Z[i] = xns_[m1 - i];
   }
   for (size_t i = 0; i < m2; i++)
   {
     mul(Z[m1 + i], xns[i], x);
   }
   mul(Z[m1 + m2], x, x);
-
-  // ret = [t_..., r_]
-  // t_ = Z * T
-  mul(ret, Z, T);
-
-  // r_ = Z * r
-  Mat<ZZ_p> r_;
-  r_.SetDims(1, ri.length());
-  r_[0] = ri;
-  transpose(r_, r_);
-
-  Vec<ZZ_p> r__;
-  mul(r__, Z, r_);
-
-  ret.append(r__);
 }
 
 bool PolynomialCommitment::verify(
     size_t m1, size_t m2, size_t n,
     const Vec<ZZ_p> &pc, const Vec<ZZ_p> &pe, const ZZ_p &x)
+{
+  Vec<ZZ> exps;
+  Vec<ZZ> pcExps;
+  verifyEquation(m1, m2, n, pc, pe, x, exps, pcExps);
+  return isIdentity(commitExps(exps, threads, pc, pcExps));
+}
+
+void PolynomialCommitment::verifyEquation(
+    size_t m1, size_t m2, size_t n,
+    const Vec<ZZ_p> &pc, const Vec<ZZ_p> &pe, const ZZ_p &x,
+    Vec<ZZ> &exps, Vec<ZZ> &pcExps)
 {
   size_t m = m1 + m2 + 1;
   if (pc.length() != m)
     throw invalid_argument("commitments count does not match with (m1 + m2 + 1)");
   if (pe.length() != n + 1)
     throw invalid_argument("evaluate results count does not match with (n + 1)");
+  if (n > gi.length())
+    throw invalid_argument("message length exceeds the number of generators");
+
+  // commit(t_, r) = U^(x^2) * Product(Ti' ^ (x^-((m1 - i) * n))) * Product(Ti'' ^ (x^(i * n + 1)))
+  // as one multi-exponentiation:
+  // g^-r * Product(gi ^ -t_) * U^(x^2) * Product(Ti' ^ ...) * Product(Ti'' ^ ...) = 1
+  exps.SetLength(n + 1);
+  pcExps.SetLength(m);
+  ZZ_pPush push(p);
 
-  ZZ_pPush push;
-
-  Vec<ZZ_p> t_;
-  ConvertUtils::subVec(pe, t_, 0, n);
-  ZZ_p r = pe[n];
-
-  auto c1 = commit(t_, r);
-
-  // U ^ (x ^ 2)
-  ZZ_p exp;
-  ZZ_p Ti;
-  ZZ_p c2 = pc[pc.length() - 1];
-  {
-    ZZ_p::init(p);
-
-    mul(exp, x, x);
+  // g and gi have order p, their exponents are negated
+  exps[0] = -rep(pe[n]);
+  for (size_t i = 0; i < n; i++)
+    exps[i + 1] = -rep(pe[i]);
 
-    ZZ_p::init(Q);
-    power(c2, c2, conv<ZZ>(exp));
-  }
+  // [x^n, x^2n, ...] and [x^-n, x^-2n, ...], one inversion only
+  ZZ_p xn = power(x, n);
+  Vec<ZZ_p> xns, xns_;
+  MathUtils::powerVecZZ_p(xn, m2, p, xns);
+  MathUtils::powerVecZZ_p(inv(xn), m1 + 1, p, xns_);
 
-  // Product(Ti' ^ (x ^ ((i - m1) * n)))
   for (size_t i = 0; i < m1; i++)
-  {
-    // TODO: use powerVec to calc
-    ZZ_p::init(p);
-    power(exp, x, (m1 - i) * n);
-    inv(exp, exp);
-
-    ZZ_p::init(Q);
-    power(Ti, pc[i], conv<ZZ>(exp));
-    mul(c2, c2, Ti);
-  }
-
-  // Product(Ti'' ^ (x ^ (i * n + 1)))
+    pcExps[i] = rep(xns_[m1 - i]);
   for (size_t i = 0; i < m2; i++)
-  {
-    ZZ_p::init(p);
-    power(exp, x, i * n + 1);
-
-    ZZ_p::init(Q);
-    power(Ti, pc[m1 + i], conv<ZZ>(exp));
-    mul(c2, c2, Ti);
-  }
-
-  // verify
-  return c1 == c2;
+    pcExps[m1 + i] = rep(xns[i] * x);
+  pcExps[m - 1] = rep(x * x);
 }
 
 ZZ_p PolynomialCommitment::calcV(size_t n, const Vec<ZZ_p> &pe, const ZZ_p &x)
@@ -9,8 +9,12 @@
 #include <NTL/ZZ_pX.h>
 
 #include "./PaillierEncryption.hpp"
+#include "./RandomnessPool.hpp"
 #include "./utils/ConvertUtils.hpp"
 #include "./math/MathUtils.hpp"
+#include "./math/MultiExp.hpp"
+#include "./math/FixedBase.hpp"
+#include "./math/CompactMat.hpp"
 
 namespace polyu
 {
@@ -20,6 +24,22 @@ namespace polyu
  */
 class PolynomialCommitment
 {
+private:
+  /// @brief Fixed base tables of the leading bases [g, g0, g1, ...]
+  vector<FixedBase> tables;
+
+  void commitRows(size_t m, const function<ZZ_p(size_t, size_t)> &commitRow, Vec<ZZ_p> &ret);
+
+  void messageExps(const Vec<ZZ_p> &mi, Vec<ZZ> &exps); // exps[0] is left for the randomness
+
+  void sampleBlinding(ZZ_p &r, ZZ_p &gr); // fresh (r, g^r) without the pool
+
+  void evalZ(size_t m1, size_t m2, size_t n, const ZZ_p &x, Vec<ZZ_p> &Z);
+
+  // ret = [Z * T, Z * ri], mulAdd(acc, z, i, j) adds z * T[i][j] to acc
+  template <typename MulAdd>
+  void evalRows(size_t n, const Vec<ZZ_p> &Z, const Vec<ZZ_p> &ri, const MulAdd &mulAdd, Vec<ZZ_p> &ret);
+
 public:
   /**
    * @brief Group element Q
@@ -41,6 +61,16 @@ public:
    */
   Vec<ZZ_p> gi;
 
+  /**
+   * @brief Thread budget of commitments, 0 means use the default thread budget
+   */
+  size_t threads = 0;
+
+  /**
+   * @brief Pool of precomputed blinding pairs (r, g^r), nullptr if not attached
+   */
+  shared_ptr<RandomnessPool> pool = nullptr;
+
   /**
    * @brief Construct a new polynomial commitment scheme
    *
@@ -78,6 +108,95 @@ public:
    */
   PolynomialCommitment(const ZZ &Q, const ZZ &p, const ZZ_p &g, size_t n);
 
+  ~PolynomialCommitment();
+
+  // the blinding pool refers to this instance
+  PolynomialCommitment(const PolynomialCommitment &) = delete;
+  PolynomialCommitment &operator=(const PolynomialCommitment &) = delete;
+
+  /**
+   * @brief Attach a blinding pool, background threads keep (r, g^r) pairs ready for commitments
+   *
+   * @param depth Number of pairs to keep ready
+   * @param threads Number of background threads, 0 means no background refill
+   */
+  void attachPool(size_t depth, size_t threads = 1);
+
+  /**
+   * @brief Stop and detach the blinding pool
+   */
+  void detachPool();
+
+  /**
+   * @brief Pick randomness (r) with precomputed g^r, taken from the blinding pool if it is attached and not empty
+   *
+   * @param r Randomness (r), under modulus p
+   * @param gr g^r, under modulus Q
+   */
+  void pickBlinding(ZZ_p &r, ZZ_p &gr);
+
+  /**
+   * @brief Pick a list of randomness with precomputed g^r
+   *
+   * @param count Number of pairs
+   * @param rs Randomness (rs), under modulus p
+   * @param grs g^rs, under modulus Q
+   */
+  void pickBlinding(size_t count, Vec<ZZ_p> &rs, Vec<ZZ_p> &grs);
+
+  /**
+   * @brief Estimate the memory of the fixed base tables of g and the leading generators. The table of g covers full width exponents (the randomness), the tables of gi only cover short exponents, eg. wire values
+   *
+   * @param count Number of tables, g included
+   * @param window Window size, 0 means default (4)
+   * @return size_t Number of bytes
+   */
+  size_t tableBytes(size_t count, long window = 0) const;
+
+  /**
+   * @brief Precompute fixed base tables for g and the leading generators gi, as many as the memory budget allows. Full width exponents of gi still go through the multi-exponentiation
+   *
+   * @param memoryBudget Memory budget in bytes
+   * @param window Window size, 0 means default (4)
+   * @return size_t Number of tables built
+   */
+  size_t precompute(size_t memoryBudget, long window = 0);
+
+  /**
+   * @brief Use precomputed tables, eg. loaded from a parameter bundle. Tables are matched in the order of [g, g0, g1, ...] and the first mismatch ends the list
+   *
+   * @param tables Fixed base tables
+   * @return size_t Number of tables in use
+   */
+  size_t setTables(const vector<FixedBase> &tables);
+
+  /**
+   * @brief Get the fixed base tables in use, in the order of [g, g0, g1, ...]
+   *
+   * @return const vector<FixedBase>&
+   */
+  const vector<FixedBase> &getTables() const;
+
+  /**
+   * @brief Calculate g^exps[0] * Product(gi ^ exps[i + 1]) * Product(extra ^ extraExps), exponents are routed by size: zero is skipped, one is a plain product, g and short exponents of gi use the fixed base tables if precomputed, the rest take separate multi-exponentiations for small and full width exponents. Negative exponents of g and gi are inverted once at the end, since they have order p
+   *
+   * @param exps Signed exponents of g and gi
+   * @param threads Number of threads
+   * @param extra Extra bases, eg. commitments
+   * @param extraExps Non-negative exponents of the extra bases
+   * @return ZZ_p
+   */
+  ZZ_p commitExps(const Vec<ZZ> &exps, size_t threads, const Vec<ZZ_p> &extra = Vec<ZZ_p>(), const Vec<ZZ> &extraExps = Vec<ZZ>());
+
+  /**
+   * @brief Check the result of a group equation, x^f = 1 where f = (Q - 1) / p. The commitments are only binding in the order p subgroup, a component of small order (eg. -1) is cleared, the same as in the batch verification
+   *
+   * @param x Result of a group equation
+   * @return true
+   * @return false
+   */
+  bool isIdentity(const ZZ_p &x) const;
+
   /**
    * @brief Commit a message
    *
@@ -88,7 +207,45 @@ public:
   ZZ_p commit(const Vec<ZZ_p> &mi, const ZZ_p &r);
 
   /**
-   * @brief Commit multiple messages
+   * @brief Commit a message, the multi-exponentiation is split across threads
+   *
+   * @param mi Message (m)
+   * @param r Randomness (r)
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return ZZ_p Commitment (c)
+   */
+  ZZ_p commit(const Vec<ZZ_p> &mi, const ZZ_p &r, size_t threads);
+
+  /**
+   * @brief Commit a message with precomputed blinding g^r
+   *
+   * @param mi Message (m)
+   * @param gr Blinding g^r
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return ZZ_p Commitment (c)
+   */
+  ZZ_p commitBlinded(const Vec<ZZ_p> &mi, const ZZ_p &gr, size_t threads = 0);
+
+  /**
+   * @brief Commit multiple messages with precomputed blinding g^rs
+   *
+   * @param ms Messages (ms)
+   * @param grs Blinding g^rs
+   * @param ret Commitments result
+   */
+  void commitBlinded(const Mat<ZZ_p> &ms, const Vec<ZZ_p> &grs, Vec<ZZ_p> &ret);
+
+  /**
+   * @brief Commit multiple messages stored in a compact matrix with precomputed blinding g^rs
+   *
+   * @param ms Messages (ms)
+   * @param grs Blinding g^rs
+   * @param ret Commitments result
+   */
+  void commitBlinded(const CompactMat &ms, const Vec<ZZ_p> &grs, Vec<ZZ_p> &ret);
+
+  /**
+   * @brief Commit multiple messages, rows are committed concurrently and the remaining thread budget splits each row
    *
    * @param ms Messages (ms)
    * @param rs Randomness (rs)
@@ -96,6 +253,15 @@ public:
    */
   void commit(const Mat<ZZ_p> &ms, const Vec<ZZ_p> &rs, Vec<ZZ_p> &ret);
 
+  /**
+   * @brief Commit multiple messages stored in a compact matrix, the small values are used as exponents directly
+   *
+   * @param ms Messages (ms)
+   * @param rs Randomness (rs)
+   * @param ret Commitments result
+   */
+  void commit(const CompactMat &ms, const Vec<ZZ_p> &rs, Vec<ZZ_p> &ret);
+
   /**
    * @brief Calculate matrix (T) for polynomial commitment
    *
@@ -116,7 +282,7 @@ public:
    * @param m2
    * @param n
    * @param T Matrix (T)
-   * @param ri Randomness (r_i)
+   * @param ri Randomness (r_i), picked from the blinding pool if it is empty
    * @param ret Commitments result (pc)
    */
   void commit(
@@ -155,6 +321,23 @@ public:
       size_t m1, size_t m2, size_t n,
       const Vec<ZZ_p> &pc, const Vec<ZZ_p> &pe, const ZZ_p &x);
 
+  /**
+   * @brief Build the group equation checked by verify, g^exps[0] * Product(gi ^ exps[i + 1]) * Product(pc ^ pcExps) = 1
+   *
+   * @param m1
+   * @param m2
+   * @param n
+   * @param pc Commitments result (pc)
+   * @param pe Evaluate result (pe)
+   * @param x Challenge value (x)
+   * @param exps Signed exponents of g and gi
+   * @param pcExps Exponents of pc
+   */
+  void verifyEquation(
+      size_t m1, size_t m2, size_t n,
+      const Vec<ZZ_p> &pc, const Vec<ZZ_p> &pe, const ZZ_p &x,
+      Vec<ZZ> &exps, Vec<ZZ> &pcExps);
+
   /**
    * @brief Calculate v = t(x)
    *
@@ -0,0 +1,114 @@
+#include "./Proof.hpp"
+
+#include <fstream>
+#include <cstring>
+
+#include "./utils/SectionFile.hpp"
+
+namespace
+{
+const char MAGIC[8] = {'Z', 'K', 'P', 'P', 'R', 'O', 'O', 'F'};
+const size_t HEADER_SIZE = 12;
+const size_t FIELD_COUNT = 7;
+const size_t FIELD_HEADER_SIZE = 8;
+
+void putVec(binary_t &out, const Vec<ZZ_p> &values)
+{
+  long elementBytes = 1;
+  for (long i = 0; i < values.length(); i++)
+    elementBytes = max(elementBytes, NumBytes(rep(values[i])));
+
+  size_t pos = out.size();
+  out.resize(pos + FIELD_HEADER_SIZE + elementBytes * values.length(), 0);
+  SectionFile::putU32(out.data() + pos, values.length());
+  SectionFile::putU32(out.data() + pos + 4, elementBytes);
+  for (long i = 0; i < values.length(); i++)
+    BytesFromZZ(out.data() + pos + FIELD_HEADER_SIZE + i * elementBytes, rep(values[i]), elementBytes);
+}
+
+void getVec(const binary_t &data, size_t &pos, const ZZ &modulus, Vec<ZZ_p> &ret)
+{
+  if (data.size() - pos < FIELD_HEADER_SIZE)
+    throw invalid_argument("invalid proof: truncated");
+
+  size_t count = SectionFile::getU32(data.data() + pos);
+  size_t elementBytes = SectionFile::getU32(data.data() + pos + 4);
+  pos += FIELD_HEADER_SIZE;
+  if (elementBytes == 0 || count > (data.size() - pos) / elementBytes)
+    throw invalid_argument("invalid proof: truncated");
+
+  ZZ_pPush push(modulus);
+  ret.SetLength(count);
+  ZZ v;
+  for (size_t i = 0; i < count; i++)
+  {
+    ZZFromBytes(v, data.data() + pos + i * elementBytes, elementBytes);
+    if (v >= modulus)
+      throw invalid_argument("invalid proof: value out of range");
+    conv(ret[i], v);
+  }
+  pos += count * elementBytes;
+}
+} // namespace
+
+binary_t Proof::toBinary() const
+{
+  binary_t ret(HEADER_SIZE, 0);
+  memcpy(ret.data(), MAGIC, sizeof(MAGIC));
+  SectionFile::putU32(ret.data() + 8, VERSION);
+
+  putVec(ret, Cm);
+  putVec(ret, Cm_);
+  putVec(ret, CRj);
+  putVec(ret, Lj);
+  putVec(ret, commits);
+  putVec(ret, pc);
+  putVec(ret, proofs);
+  return ret;
+}
+
+Proof Proof::fromBinary(const binary_t &data, const ZZ &GP_Q, const ZZ &GP_P)
+{
+  if (data.size() < HEADER_SIZE || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+    throw invalid_argument("invalid proof: bad magic");
+  if (SectionFile::getU32(data.data() + 8) != VERSION)
+    throw invalid_argument("invalid proof: unsupported version");
+
+  Proof ret;
+  size_t pos = HEADER_SIZE;
+  getVec(data, pos, GP_P, ret.Cm);
+  getVec(data, pos, GP_P, ret.Cm_);
+  getVec(data, pos, GP_P, ret.CRj);
+  getVec(data, pos, GP_P, ret.Lj);
+  getVec(data, pos, GP_Q, ret.commits);
+  getVec(data, pos, GP_Q, ret.pc);
+  getVec(data, pos, GP_P, ret.proofs);
+  if (pos != data.size())
+    throw invalid_argument("invalid proof: trailing data");
+  return ret;
+}
+
+size_t Proof::maxBytes(size_t countP, size_t countQ, const ZZ &GP_Q, const ZZ &GP_P)
+{
+  // values are written with the width of the largest one, which is below its modulus
+  return HEADER_SIZE + FIELD_COUNT * FIELD_HEADER_SIZE + countP * NumBytes(GP_P) + countQ * NumBytes(GP_Q);
+}
+
+void Proof::save(const string &path) const
+{
+  auto data = toBinary();
+  ofstream fs(path, ios::binary | ios::trunc);
+  if (!fs)
+    throw invalid_argument("cannot open proof for writing: " + path);
+  fs.write((const char *)data.data(), data.size());
+  if (!fs)
+    throw runtime_error("failed to write proof: " + path);
+}
+
+binary_t Proof::read(const string &path)
+{
+  ifstream fs(path, ios::binary);
+  if (!fs)
+    throw invalid_argument("cannot open proof: " + path);
+  return binary_t((istreambuf_iterator<char>(fs)), istreambuf_iterator<char>());
+}
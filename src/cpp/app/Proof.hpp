@@ -0,0 +1,89 @@
+#pragma once
+
+#include "./namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+
+namespace polyu
+{
+
+/**
+ * @brief _Proof_ holds everything the prover sends for one batch of encryptions, so a verifier can check it without other state.
+ *
+ * Binary layout (little-endian):
+ *   header    magic "ZKPPROOF", u32 version
+ *   fields    Cm, Cm_, CRj, Lj, commits, pc, proofs; each as u32 element count, u32 element bytes, fixed width elements
+ */
+class Proof
+{
+public:
+  static const uint32_t VERSION = 1;
+
+  /// @brief Ciphertexts of messages
+  Vec<ZZ_p> Cm;
+
+  /// @brief Ciphertexts of auxiliary messages
+  Vec<ZZ_p> Cm_;
+
+  /// @brief Ciphertexts of range proof masks
+  Vec<ZZ_p> CRj;
+
+  /// @brief Challenge response (L_j = l * b + R_j) for range proof
+  Vec<ZZ_p> Lj;
+
+  /// @brief Commitments of A, B, C and D, under modulus Q
+  Vec<ZZ_p> commits;
+
+  /// @brief Polynomial commitments of t(X), under modulus Q
+  Vec<ZZ_p> pc;
+
+  /// @brief The proofs list (pe, r, rr)
+  Vec<ZZ_p> proofs;
+
+  /**
+   * @brief Serialize the proof
+   *
+   * @return binary_t
+   */
+  binary_t toBinary() const;
+
+  /**
+   * @brief Parse a proof, the values are checked against their modulus
+   *
+   * @param data Serialized proof
+   * @param GP_Q Group element Q
+   * @param GP_P Group element p
+   * @return Proof
+   */
+  static Proof fromBinary(const binary_t &data, const ZZ &GP_Q, const ZZ &GP_P);
+
+  /**
+   * @brief Largest size of a serialized proof
+   *
+   * @param countP Number of values under modulus p (Cm, Cm_, CRj, Lj and proofs)
+   * @param countQ Number of values under modulus Q (commits and pc)
+   * @param GP_Q Group element Q
+   * @param GP_P Group element p
+   * @return size_t Number of bytes
+   */
+  static size_t maxBytes(size_t countP, size_t countQ, const ZZ &GP_Q, const ZZ &GP_P);
+
+  /**
+   * @brief Write the proof to a file
+   *
+   * @param path File path
+   */
+  void save(const string &path) const;
+
+  /**
+   * @brief Read a proof file
+   *
+   * @param path File path
+   * @return binary_t Serialized proof
+   */
+  static binary_t read(const string &path);
+};
+
+} // namespace polyu
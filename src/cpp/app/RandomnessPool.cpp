@@ -0,0 +1,154 @@
+#include "./RandomnessPool.hpp"
+
+RandomnessPool::RandomnessPool(const function<void(ZZ_p &r, ZZ_p &rx)> &producer, size_t depth, size_t threads)
+    : hits(0), misses(0), refills(0)
+{
+  this->producer = producer;
+  this->depth = depth;
+  this->threads = threads;
+  start();
+}
+
+RandomnessPool::~RandomnessPool()
+{
+  stop();
+}
+
+void RandomnessPool::start()
+{
+  {
+    lock_guard<mutex> guard(lock);
+    if (!stopping)
+      return;
+    stopping = false;
+    alive += threads;
+    error = nullptr;
+  }
+
+  for (size_t i = 0; i < threads; i++)
+  {
+    // each worker has its own random stream, seeded from the caller's one
+    auto seed = RandomBits_ZZ(256);
+    workers.push_back(thread(&RandomnessPool::work, this, seed));
+  }
+}
+
+void RandomnessPool::stop()
+{
+  {
+    lock_guard<mutex> guard(lock);
+    stopping = true;
+  }
+  notFull.notify_all();
+  filled.notify_all();
+
+  for (auto &w : workers)
+    w.join();
+  workers.clear();
+}
+
+void RandomnessPool::work(const ZZ &seed)
+{
+  SetSeed(seed);
+
+  ZZ_p r, rx;
+  while (true)
+  {
+    {
+      unique_lock<mutex> guard(lock);
+      notFull.wait(guard, [this]() { return stopping || pairs.size() + pending < depth; });
+      if (stopping)
+      {
+        alive--;
+        return;
+      }
+      pending++;
+    }
+
+    try
+    {
+      producer(r, rx);
+    }
+    catch (...)
+    {
+      // leave the pool to the online path, requests will count as misses
+      {
+        lock_guard<mutex> guard(lock);
+        pending--;
+        alive--;
+        error = current_exception();
+      }
+      filled.notify_all();
+      return;
+    }
+
+    {
+      lock_guard<mutex> guard(lock);
+      pending--;
+      pairs.push_back(make_pair(r, rx));
+    }
+    refills++;
+    filled.notify_all();
+  }
+}
+
+void RandomnessPool::warmUp()
+{
+  if (threads == 0)
+  {
+    ZZ_p r, rx;
+    while (size() < depth)
+    {
+      producer(r, rx);
+      lock_guard<mutex> guard(lock);
+      pairs.push_back(make_pair(r, rx));
+      refills++;
+    }
+    return;
+  }
+
+  unique_lock<mutex> guard(lock);
+  filled.wait(guard, [this]() { return stopping || alive == 0 || pairs.size() >= depth; });
+  if (pairs.size() < depth && error)
+    rethrow_exception(error);
+}
+
+bool RandomnessPool::take(ZZ_p &r, ZZ_p &rx)
+{
+  {
+    lock_guard<mutex> guard(lock);
+    if (pairs.empty())
+    {
+      misses++;
+      return false;
+    }
+
+    r = pairs.front().first;
+    rx = pairs.front().second;
+    pairs.pop_front();
+  }
+  hits++;
+  notFull.notify_one();
+  return true;
+}
+
+size_t RandomnessPool::size()
+{
+  lock_guard<mutex> guard(lock);
+  return pairs.size();
+}
+
+size_t RandomnessPool::getHits()
+{
+  return hits;
+}
+
+size_t RandomnessPool::getMisses()
+{
+  return misses;
+}
+
+size_t RandomnessPool::getRefills()
+{
+  return refills;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "./namespace.hpp"
+
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+
+namespace polyu
+{
+
+/**
+ * @brief _RandomnessPool_ keeps a queue of precomputed randomness pairs, eg. (r, r^n) for paillier encryption. Background threads refill the queue up to the configured depth, so the online path only takes a ready pair.
+ */
+class RandomnessPool
+{
+private:
+  function<void(ZZ_p &r, ZZ_p &rx)> producer;
+  size_t depth;
+  size_t threads;
+
+  deque<pair<ZZ_p, ZZ_p>> pairs;
+  size_t pending = 0;
+  size_t alive = 0;      // workers still running
+  exception_ptr error;   // the last producer failure of a worker
+  bool stopping = true;
+  mutex lock;
+  condition_variable notFull;
+  condition_variable filled;
+  vector<thread> workers;
+
+  atomic<size_t> hits;
+  atomic<size_t> misses;
+  atomic<size_t> refills;
+
+  void work(const ZZ &seed);
+
+public:
+  /**
+   * @brief Construct a new randomness pool, the background threads are started immediately
+   *
+   * @param producer Function to compute a new pair (r, r^x)
+   * @param depth Number of pairs to keep ready
+   * @param threads Number of background threads, 0 means no background refill
+   */
+  RandomnessPool(const function<void(ZZ_p &r, ZZ_p &rx)> &producer, size_t depth, size_t threads = 1);
+
+  ~RandomnessPool();
+
+  RandomnessPool(const RandomnessPool &) = delete;
+  RandomnessPool &operator=(const RandomnessPool &) = delete;
+
+  /**
+   * @brief Start the background threads
+   */
+  void start();
+
+  /**
+   * @brief Stop and join the background threads, the ready pairs are kept
+   */
+  void stop();
+
+  /**
+   * @brief Block until the pool is filled up to its depth, computes on the caller thread if there is no background thread. Rethrows the producer failure if all background threads have exited
+   */
+  void warmUp();
+
+  /**
+   * @brief Take a ready pair from the pool
+   *
+   * @param r Randomness (r)
+   * @param rx Precomputed value of r
+   * @return true Hit, the pair is assigned
+   * @return false Miss, the pool is empty
+   */
+  bool take(ZZ_p &r, ZZ_p &rx);
+
+  /**
+   * @brief Number of ready pairs
+   *
+   * @return size_t
+   */
+  size_t size();
+
+  /**
+   * @brief Number of pairs served from the pool
+   *
+   * @return size_t
+   */
+  size_t getHits();
+
+  /**
+   * @brief Number of requests found the pool empty
+   *
+   * @return size_t
+   */
+  size_t getMisses();
+
+  /**
+   * @brief Number of pairs computed for the pool
+   *
+   * @return size_t
+   */
+  size_t getRefills();
+};
+
+} // namespace polyu
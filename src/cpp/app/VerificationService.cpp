@@ -0,0 +1,365 @@
+#include "./VerificationService.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "./utils/Parallel.hpp"
+#include "./utils/SectionFile.hpp"
+#include "./utils/Timer.hpp"
+
+namespace
+{
+const string SUFFIX = ".proof";
+
+bool readAll(int fd, uint8_t *buf, size_t len)
+{
+  while (len > 0)
+  {
+    auto n = recv(fd, buf, len, 0);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n <= 0)
+      return false;
+    buf += n;
+    len -= n;
+  }
+  return true;
+}
+} // namespace
+
+double VerificationService::Stats::proofsPerSecond() const
+{
+  return seconds > 0 ? proofs / seconds : 0;
+}
+
+VerificationService::VerificationService(const shared_ptr<const VerifierKey> &key,
+                                         const shared_ptr<PolynomialCommitment> &commitScheme,
+                                         size_t threads)
+{
+  if (!key->matches(*commitScheme))
+    throw invalid_argument("commitment scheme do not match with the group of the key");
+
+  this->key = key;
+  this->commitScheme = commitScheme;
+  this->maxProofBytes = key->proofBytes();
+
+  // one proof per worker, the verifiers must not spawn threads of their own
+  commitScheme->threads = 1;
+
+  threads = Parallel::threadCount(threads);
+  for (size_t i = 0; i < threads; i++)
+    workers.push_back(thread(&VerificationService::work, this));
+}
+
+VerificationService::~VerificationService()
+{
+  stop();
+  {
+    lock_guard<mutex> guard(lock);
+    closing = true;
+  }
+  ready.notify_all();
+
+  for (auto &w : workers)
+    w.join();
+}
+
+void VerificationService::work()
+{
+  Timer::silent = true;
+
+  while (true)
+  {
+    function<void()> job;
+    {
+      unique_lock<mutex> guard(lock);
+      ready.wait(guard, [this]() { return closing || !jobs.empty(); });
+      if (jobs.empty())
+        return;
+      job = move(jobs.front());
+      jobs.pop_front();
+    }
+    job();
+  }
+}
+
+void VerificationService::record(bool valid, bool malformed, const VerifierKey::Latency &latency)
+{
+  auto now = chrono::steady_clock::now();
+
+  lock_guard<mutex> guard(statsLock);
+  stats.proofs++;
+  if (valid)
+    stats.valid++;
+  if (malformed)
+    stats.malformed++;
+  stats.circuit += latency.circuit;
+  stats.verify += latency.verify;
+  stats.maxLatency = max(stats.maxLatency, latency.circuit + latency.verify);
+  stats.seconds = chrono::duration<double>(now - firstStart).count();
+}
+
+future<bool> VerificationService::submit(const binary_t &data)
+{
+  auto task = make_shared<packaged_task<bool()>>([this, data]() {
+    VerifierKey::Latency latency;
+    bool valid;
+    try
+    {
+      auto proof = Proof::fromBinary(data, key->getGroupQ(), key->getGroupP());
+      valid = key->verify(proof, commitScheme, &latency);
+    }
+    catch (const exception &)
+    {
+      record(false, true, latency);
+      return false;
+    }
+    record(valid, false, latency);
+    return valid;
+  });
+  auto ret = task->get_future();
+
+  {
+    lock_guard<mutex> guard(statsLock);
+    if (firstStart == chrono::steady_clock::time_point())
+      firstStart = chrono::steady_clock::now();
+  }
+  {
+    lock_guard<mutex> guard(lock);
+    jobs.push_back([task]() { (*task)(); });
+  }
+  ready.notify_one();
+  return ret;
+}
+
+size_t VerificationService::scan(const string &dir, ostream &out, set<string> &seen)
+{
+  auto d = opendir(dir.c_str());
+  if (!d)
+    throw invalid_argument("cannot open proof directory: " + dir);
+
+  vector<string> names;
+  while (auto e = readdir(d))
+  {
+    string name = e->d_name;
+    if (name.size() > SUFFIX.size() &&
+        name.compare(name.size() - SUFFIX.size(), SUFFIX.size(), SUFFIX) == 0 &&
+        seen.insert(name).second)
+      names.push_back(name);
+  }
+  closedir(d);
+  sort(names.begin(), names.end());
+
+  vector<future<bool>> results;
+  for (auto &name : names)
+  {
+    binary_t data;
+    try
+    {
+      data = Proof::read(dir + "/" + name);
+    }
+    catch (const invalid_argument &)
+    {
+      // unreadable file, counted as a malformed proof
+    }
+    results.push_back(submit(data));
+  }
+
+  size_t ret = 0;
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    bool valid = results[i].get();
+    if (valid)
+      ret++;
+    out << names[i] << (valid ? " valid" : " invalid") << endl;
+  }
+  return ret;
+}
+
+size_t VerificationService::verifyDirectory(const string &dir, ostream &out)
+{
+  set<string> seen;
+  return scan(dir, out, seen);
+}
+
+void VerificationService::watchDirectory(const string &dir, ostream &out, size_t interval)
+{
+  set<string> seen;
+  while (true)
+  {
+    {
+      lock_guard<mutex> guard(lock);
+      if (stopRequested)
+        return;
+    }
+
+    scan(dir, out, seen);
+
+    unique_lock<mutex> guard(lock);
+    if (stopped.wait_for(guard, chrono::milliseconds(interval), [this]() { return stopRequested; }))
+      return;
+  }
+}
+
+void VerificationService::serve(const string &path)
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path))
+    throw invalid_argument("socket path is too long: " + path);
+  memcpy(addr.sun_path, path.c_str(), path.size());
+
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0)
+    throw runtime_error("cannot create socket: " + path);
+  unlink(path.c_str());
+  if (::bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0)
+  {
+    close(fd);
+    throw runtime_error("cannot listen on socket: " + path);
+  }
+
+  {
+    lock_guard<mutex> guard(lock);
+    if (stopRequested)
+    {
+      close(fd);
+      unlink(path.c_str());
+      return;
+    }
+    listenFd = fd;
+  }
+
+  bool failed = false;
+  while (true)
+  {
+    int client = accept(fd, nullptr, nullptr);
+    int err = errno;
+
+    // join the clients that have finished
+    vector<thread> done;
+    bool leave = false;
+    {
+      lock_guard<mutex> guard(lock);
+      for (auto id : finished)
+      {
+        done.push_back(move(connections[id]));
+        connections.erase(id);
+      }
+      finished.clear();
+
+      if (client < 0)
+      {
+        leave = stopRequested || (err != EINTR && err != ECONNABORTED);
+        failed = !stopRequested && leave;
+      }
+      else if (stopRequested)
+      {
+        close(client);
+        leave = true;
+      }
+      else if (clients.size() >= MAX_CLIENTS)
+      {
+        close(client);
+      }
+      else
+      {
+        size_t id = nextClient++;
+        clients[id] = client;
+        connections[id] = thread(&VerificationService::handle, this, id, client);
+      }
+    }
+    for (auto &t : done)
+      t.join();
+    if (leave)
+      break;
+  }
+
+  // wake up the remaining clients and wait for them
+  vector<thread> done;
+  {
+    lock_guard<mutex> guard(lock);
+    for (auto &c : clients)
+      shutdown(c.second, SHUT_RDWR);
+    for (auto &c : connections)
+      done.push_back(move(c.second));
+    connections.clear();
+    finished.clear();
+    listenFd = -1;
+  }
+  for (auto &t : done)
+    t.join();
+  close(fd);
+  unlink(path.c_str());
+
+  if (failed)
+    throw runtime_error("failed to accept on socket: " + path);
+}
+
+void VerificationService::handle(size_t id, int fd)
+{
+  try
+  {
+    uint8_t header[4];
+    while (readAll(fd, header, sizeof(header)))
+    {
+      size_t size = SectionFile::getU32(header);
+      if (size > maxProofBytes)
+        break;
+      binary_t data(size);
+      if (!readAll(fd, data.data(), size))
+        break;
+
+      uint8_t reply = submit(data).get() ? 1 : 0;
+      if (send(fd, &reply, 1, MSG_NOSIGNAL) != 1)
+        break;
+    }
+  }
+  catch (const exception &)
+  {
+    // drop the client
+  }
+
+  lock_guard<mutex> guard(lock);
+  clients.erase(id);
+  finished.push_back(id);
+  close(fd);
+}
+
+void VerificationService::stop()
+{
+  {
+    lock_guard<mutex> guard(lock);
+    stopRequested = true;
+    // wake up the blocking accept and recv calls
+    if (listenFd >= 0)
+      shutdown(listenFd, SHUT_RDWR);
+    for (auto &c : clients)
+      shutdown(c.second, SHUT_RDWR);
+  }
+  stopped.notify_all();
+}
+
+VerificationService::Stats VerificationService::getStats()
+{
+  lock_guard<mutex> guard(statsLock);
+  return stats;
+}
+
+void VerificationService::report(ostream &out)
+{
+  auto s = getStats();
+  double count = s.proofs > 0 ? s.proofs : 1;
+  out << "proofs: " << s.proofs << ", valid: " << s.valid << ", malformed: " << s.malformed << endl;
+  out << "proofs/sec: " << s.proofsPerSecond() << endl;
+  out << "latency (ms): circuit " << s.circuit * 1000 / count
+      << ", verify " << s.verify * 1000 / count
+      << ", max " << s.maxLatency * 1000 << endl;
+}
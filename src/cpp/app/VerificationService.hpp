@@ -0,0 +1,145 @@
+#pragma once
+
+#include "./namespace.hpp"
+
+#include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <ostream>
+#include <functional>
+#include <condition_variable>
+
+#include "./Proof.hpp"
+#include "./VerifierKey.hpp"
+#include "./PolynomialCommitment.hpp"
+
+namespace polyu
+{
+
+/**
+ * @brief _VerificationService_ verifies serialized proofs against one _VerifierKey_ on a pool of worker threads. Proofs are read from a directory or from clients of a unix socket, and the throughput and per-phase latency are collected.
+ *
+ * Socket protocol: the client sends frames of u32 length (little-endian) followed by the serialized proof, the service replies 1 byte per frame, 1 for a valid proof and 0 otherwise.
+ */
+class VerificationService
+{
+public:
+  /// @brief Max number of socket clients served at once, further clients are closed
+  static const size_t MAX_CLIENTS = 64;
+
+  struct Stats
+  {
+    size_t proofs = 0;     // proofs verified
+    size_t valid = 0;      // proofs accepted
+    size_t malformed = 0;  // proofs could not be parsed or checked
+    double seconds = 0;    // wall time from the first proof to the last result
+    double circuit = 0;    // total latency of patching the circuit
+    double verify = 0;     // total latency of checking the proofs
+    double maxLatency = 0; // slowest proof
+
+    double proofsPerSecond() const;
+  };
+
+private:
+  shared_ptr<const VerifierKey> key;
+  shared_ptr<PolynomialCommitment> commitScheme;
+  size_t maxProofBytes; // largest frame accepted from a socket
+
+  deque<function<void()>> jobs;
+  bool closing = false;
+  mutex lock;
+  condition_variable ready;
+  vector<thread> workers;
+
+  bool stopRequested = false;       // set by stop(), never reset
+  int listenFd = -1;
+  size_t nextClient = 0;
+  map<size_t, int> clients;        // socket of each client
+  map<size_t, thread> connections; // thread of each client
+  vector<size_t> finished;         // clients to be joined
+  condition_variable stopped;
+
+  mutex statsLock;
+  Stats stats;
+  chrono::steady_clock::time_point firstStart;
+
+  void work();
+  void handle(size_t id, int fd);
+  void record(bool valid, bool malformed, const VerifierKey::Latency &latency);
+  size_t scan(const string &dir, ostream &out, set<string> &seen);
+
+public:
+  /**
+   * @brief Construct a new verification service, the worker threads are started immediately
+   *
+   * @param key Verifier key of the circuit
+   * @param commitScheme Polynomial commitment scheme over the group of the key, it is shared by the workers and its thread budget is set to 1, the workers are the parallelism
+   * @param threads Number of worker threads, 0 means the hardware concurrency
+   */
+  VerificationService(const shared_ptr<const VerifierKey> &key,
+                      const shared_ptr<PolynomialCommitment> &commitScheme,
+                      size_t threads = 0);
+
+  /**
+   * @brief Stop serving, the queued proofs are verified before the workers are joined
+   */
+  ~VerificationService();
+
+  /**
+   * @brief Queue a serialized proof, malformed proofs are invalid
+   *
+   * @param data Serialized proof
+   * @return future<bool> Result of the verification
+   */
+  future<bool> submit(const binary_t &data);
+
+  /**
+   * @brief Verify the proof files (*.proof) in a directory, in order of name. Writes "<name> valid" or "<name> invalid" per file
+   *
+   * @param dir Directory path
+   * @param out Output stream of the results
+   * @return size_t Number of valid proofs
+   */
+  size_t verifyDirectory(const string &dir, ostream &out);
+
+  /**
+   * @brief Keep verifying the new proof files in a directory until stop() is called, returns at once if it was called before. Each file is verified once, so it should be moved into the directory after it is fully written
+   *
+   * @param dir Directory path
+   * @param out Output stream of the results
+   * @param interval Time between scans (in millisecond)
+   */
+  void watchDirectory(const string &dir, ostream &out, size_t interval = 1000);
+
+  /**
+   * @brief Accept clients on a unix socket until stop() is called, returns at once if it was called before. Each client is served by its own thread, up to MAX_CLIENTS at once, and a frame larger than the largest proof of the key closes the client
+   *
+   * @param path Socket path, an existing file is replaced
+   */
+  void serve(const string &path);
+
+  /**
+   * @brief Stop serving the socket and watching directories, the calls return once their clients are finished. A stopped service does not serve again, queued and submitted proofs are still verified
+   */
+  void stop();
+
+  /**
+   * @brief Get the statistics
+   *
+   * @return Stats
+   */
+  Stats getStats();
+
+  /**
+   * @brief Write the throughput and the average per-phase latency
+   *
+   * @param out Output stream
+   */
+  void report(ostream &out);
+};
+
+} // namespace polyu
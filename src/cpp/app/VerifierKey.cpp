@@ -0,0 +1,362 @@
+#include "./VerifierKey.hpp"
+
+#include <chrono>
+
+namespace
+{
+const string MAGIC = "ZKPVRKEY";
+const string NAME = "verifier key";
+const size_t ENTRY_BYTES = 12;
+
+SectionFile::Content encodeSizes(uint32_t id, const vector<size_t> &values)
+{
+  SectionFile::Content ret = {id, 8, binary_t(8 * values.size(), 0), 0, 0};
+  for (size_t i = 0; i < values.size(); i++)
+    SectionFile::putU64(ret.bytes.data() + 8 * i, values[i]);
+  return ret;
+}
+
+vector<size_t> decodeSizes(const SectionFile &file, const SectionFile::Section &s)
+{
+  if (s.elementBytes != 8)
+    throw invalid_argument("invalid verifier key: bad element size");
+
+  vector<size_t> ret(s.count);
+  for (size_t i = 0; i < s.count; i++)
+    ret[i] = SectionFile::getU64(file.at(s, i));
+  return ret;
+}
+
+void checkBound(const vector<size_t> &values, size_t bound)
+{
+  for (auto v : values)
+  {
+    if (v >= bound)
+      throw invalid_argument("invalid verifier key: index out of range");
+  }
+}
+} // namespace
+
+VerifierKey::VerifierKey(const shared_ptr<PaillierEncryption> &crypto,
+                         size_t msgCount, size_t rangeProofCount,
+                         size_t slotSize, size_t msgPerBatch)
+{
+  this->pk = crypto->getPublicKey();
+  this->GP_Q = crypto->getGroupQ();
+  this->GP_P = crypto->getGroupP();
+  this->GP_G = crypto->getGroupG();
+
+  this->msgCount = msgCount;
+  this->rangeProofCount = rangeProofCount;
+  this->slotSize = slotSize;
+  this->msgPerBatch = msgPerBatch;
+
+  ZZ_pPush push(GP_P);
+  auto cir = make_shared<CBatchEnc>(crypto, msgCount, rangeProofCount, slotSize, msgPerBatch);
+  this->slotsPerMsg = cir->slotsPerMsg;
+
+  // wire up with zero ciphertexts and challenges, they are patched per proof
+  Vec<ZZ_p> Cm, Cm_, CRj, Lj;
+  Cm.SetLength(msgCount);
+  Cm_.SetLength(cir->batchCount);
+  CRj.SetLength(rangeProofCount);
+  Lj.SetLength(rangeProofCount);
+  cir->setCipher(Cm, Cm_, CRj);
+  cir->wireUp(binary_t(cir->getLjLength(), 0), Lj);
+
+  auto mnCfg = CircuitZKPVerifier::calcMN(cir->gateCount);
+  cir->generateWires(mnCfg[0], mnCfg[1], Wqa, Wqb, Wqc);
+  Kq = cir->Kq;
+  cipherLinears = cir->cipherLinears;
+  rangeLinears = cir->rangeLinears;
+
+  auto position = cir->layout();
+  bitGates.resize(msgCount * slotsPerMsg);
+  for (size_t k = 0; k < bitGates.size(); k++)
+    bitGates[k] = position[cir->briOffset + k];
+}
+
+VerifierKey::VerifierKey(const string &path)
+{
+  SectionFile file(path, MAGIC, VERSION, NAME);
+  if (!file.verifyData())
+    throw invalid_argument("invalid verifier key: bad data checksum");
+
+  auto &group = file.section(SECTION_GROUP);
+  if (group.count != 4)
+    throw invalid_argument("invalid verifier key: bad group elements");
+  pk = file.element(group, 0);
+  GP_Q = file.element(group, 1);
+  GP_P = file.element(group, 2);
+  {
+    ZZ_pPush push(GP_Q);
+    conv(GP_G, file.element(group, 3));
+  }
+
+  auto settings = decodeSizes(file, file.section(SECTION_SETTINGS));
+  if (settings.size() != 7 || settings[2] == 0 || settings[3] == 0)
+    throw invalid_argument("invalid verifier key: bad settings");
+  msgCount = settings[0];
+  rangeProofCount = settings[1];
+  slotSize = settings[2];
+  msgPerBatch = settings[3];
+  slotsPerMsg = NumBytes(pk) / slotSize;
+  size_t m = settings[4];
+  size_t n = settings[5];
+  size_t Q = settings[6];
+
+  ZZ_pPush push(GP_P);
+
+  // table of distinct values, the other sections refer to it by index
+  auto &vs = file.section(SECTION_VALUES);
+  Vec<ZZ_p> values;
+  values.SetLength(vs.count);
+  for (size_t i = 0; i < vs.count; i++)
+    conv(values[i], file.element(vs, i));
+
+  auto value = [&](const uint8_t *p) -> const ZZ_p & {
+    auto idx = SectionFile::getU32(p);
+    if (idx >= (size_t)values.length())
+      throw invalid_argument("invalid verifier key: index out of range");
+    return values[idx];
+  };
+
+  auto &ks = file.section(SECTION_KQ);
+  if (ks.elementBytes != 4 || ks.count != Q)
+    throw invalid_argument("invalid verifier key: bad linear constrains");
+  Kq.SetLength(Q);
+  for (size_t q = 0; q < Q; q++)
+    Kq[q] = value(file.at(ks, q));
+
+  vector<shared_ptr<const WireMat>> wires;
+  for (size_t w = 0; w < 3; w++)
+  {
+    auto offsets = decodeSizes(file, file.section(SECTION_ROWS, w));
+    auto &es = file.section(SECTION_ENTRIES, w);
+    if (es.elementBytes != ENTRY_BYTES)
+      throw invalid_argument("invalid verifier key: bad element size");
+
+    vector<WireMat::Entry> entries(es.count);
+    Parallel::forRange(es.count, [&](size_t begin, size_t end) {
+      for (size_t k = begin; k < end; k++)
+      {
+        auto p = file.at(es, k);
+        entries[k].q = SectionFile::getU32(p);
+        entries[k].j = SectionFile::getU32(p + 4);
+        entries[k].v = value(p + 8);
+        if (entries[k].q >= Q)
+          throw invalid_argument("invalid verifier key: index out of range");
+      }
+    });
+    wires.push_back(make_shared<WireMat>(m, n, move(offsets), move(entries)));
+  }
+  Wqa = wires[0];
+  Wqb = wires[1];
+  Wqc = wires[2];
+
+  cipherLinears = decodeSizes(file, file.section(SECTION_CIPHERS));
+  rangeLinears = decodeSizes(file, file.section(SECTION_RANGES));
+  bitGates = decodeSizes(file, file.section(SECTION_BITS));
+  if (cipherLinears.size() < msgCount + rangeProofCount || rangeLinears.size() != rangeProofCount ||
+      bitGates.size() != msgCount * slotsPerMsg)
+    throw invalid_argument("invalid verifier key: bad settings");
+  checkBound(cipherLinears, Q);
+  checkBound(rangeLinears, Q);
+  checkBound(bitGates, m * n);
+}
+
+void VerifierKey::save(const string &path) const
+{
+  // distinct values of the coefficients, zero is at index 0
+  map<ZZ, uint32_t> index;
+  Vec<ZZ> values;
+  auto lookup = [&](const ZZ_p &v) {
+    auto &r = rep(v);
+    auto it = index.find(r);
+    if (it != index.end())
+      return it->second;
+    uint32_t idx = values.length();
+    index[r] = idx;
+    values.append(r);
+    return idx;
+  };
+  lookup(ZZ_p());
+
+  vector<SectionFile::Content> contents;
+
+  Vec<ZZ> group;
+  group.SetLength(4);
+  group[0] = pk;
+  group[1] = GP_Q;
+  group[2] = GP_P;
+  group[3] = rep(GP_G);
+  contents.push_back(SectionFile::encode(SECTION_GROUP, group));
+
+  contents.push_back(encodeSizes(SECTION_SETTINGS, {msgCount, rangeProofCount, slotSize, msgPerBatch, getM(), getN(), getQ()}));
+
+  SectionFile::Content kq = {SECTION_KQ, 4, binary_t(4 * Kq.length(), 0), 0, 0};
+  for (long q = 0; q < Kq.length(); q++)
+    SectionFile::putU32(kq.bytes.data() + 4 * q, lookup(Kq[q]));
+
+  vector<SectionFile::Content> wires;
+  for (auto &w : {Wqa, Wqb, Wqc})
+  {
+    auto &entries = w->getEntries();
+    SectionFile::Content es = {SECTION_ENTRIES, ENTRY_BYTES, binary_t(ENTRY_BYTES * entries.size(), 0), 0, 0};
+    for (size_t k = 0; k < entries.size(); k++)
+    {
+      auto p = es.bytes.data() + ENTRY_BYTES * k;
+      SectionFile::putU32(p, entries[k].q);
+      SectionFile::putU32(p + 4, entries[k].j);
+      SectionFile::putU32(p + 8, lookup(entries[k].v));
+    }
+    wires.push_back(encodeSizes(SECTION_ROWS, w->getOffsets()));
+    wires.push_back(move(es));
+  }
+
+  contents.push_back(SectionFile::encode(SECTION_VALUES, values));
+  contents.push_back(move(kq));
+  for (auto &c : wires)
+    contents.push_back(move(c));
+  contents.push_back(encodeSizes(SECTION_CIPHERS, cipherLinears));
+  contents.push_back(encodeSizes(SECTION_RANGES, rangeLinears));
+  contents.push_back(encodeSizes(SECTION_BITS, bitGates));
+
+  SectionFile::write(path, MAGIC, VERSION, contents, NAME);
+}
+
+bool VerifierKey::matches(const ZZ &pk, const ZZ &GP_Q, const ZZ &GP_P, const ZZ_p &GP_G,
+                          size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch) const
+{
+  return this->pk == pk && this->GP_Q == GP_Q && this->GP_P == GP_P && this->GP_G == GP_G &&
+         this->msgCount == msgCount && this->rangeProofCount == rangeProofCount &&
+         this->slotSize == slotSize && this->msgPerBatch == msgPerBatch;
+}
+
+bool VerifierKey::matches(const PolynomialCommitment &commitScheme) const
+{
+  return commitScheme.Q == GP_Q && commitScheme.p == GP_P && commitScheme.g == GP_G;
+}
+
+ZZ VerifierKey::getPublicKey() const
+{
+  return pk;
+}
+
+ZZ VerifierKey::getGroupQ() const
+{
+  return GP_Q;
+}
+
+ZZ VerifierKey::getGroupP() const
+{
+  return GP_P;
+}
+
+size_t VerifierKey::getM() const
+{
+  return Wqa->NumRows();
+}
+
+size_t VerifierKey::getN() const
+{
+  return Wqa->NumCols();
+}
+
+size_t VerifierKey::getQ() const
+{
+  return Kq.length();
+}
+
+size_t VerifierKey::proofBytes() const
+{
+  size_t m = getM();
+  size_t n = getN();
+  auto txCfg = CircuitZKPVerifier::calcM1M2N(m);
+  size_t batchCount = cipherLinears.size() - msgCount - rangeProofCount;
+
+  // Cm, Cm_, CRj, Lj and proofs (pe, r, rr) under p; commits and pc under Q
+  size_t countP = msgCount + batchCount + 2 * rangeProofCount + (txCfg[2] + 1) + n + 1;
+  size_t countQ = 3 * m + 1 + txCfg[0] + txCfg[1] + 1;
+  return Proof::maxBytes(countP, countQ, GP_Q, GP_P);
+}
+
+shared_ptr<CircuitZKPVerifier> VerifierKey::generateVerifier(
+    const Vec<ZZ_p> &Cm,
+    const Vec<ZZ_p> &Cm_,
+    const Vec<ZZ_p> &CRj,
+    const binary_t &Ljir,
+    const Vec<ZZ_p> &Lj,
+    const shared_ptr<PolynomialCommitment> &commitScheme) const
+{
+  if (commitScheme == nullptr || !matches(*commitScheme))
+    throw invalid_argument("commitment scheme do not match with the group of the key");
+
+  size_t batchCount = cipherLinears.size() - msgCount - rangeProofCount;
+  if (Cm.length() != msgCount || Cm_.length() != batchCount || CRj.length() != rangeProofCount)
+    throw invalid_argument("cipher count do not match with settings");
+  if (Lj.length() != rangeProofCount)
+    throw invalid_argument("range proof count do not match with settings");
+
+  size_t bits = msgCount * slotsPerMsg;
+  if (Ljir.size() * 8 < rangeProofCount * bits)
+    throw invalid_argument("challenge value Ljir is too short");
+
+  ZZ_pPush push(GP_P);
+  auto verifier = make_shared<CircuitZKPVerifier>(GP_Q, GP_P, GP_G, Wqa, Wqb, Wqc, Kq, commitScheme);
+  verifier->threads = commitScheme->threads;
+
+  // K_q: ciphertexts in order of Cm, CRj, Cm_, and L_j
+  auto &K = verifier->Kq;
+  size_t k = 0;
+  for (long i = 0; i < Cm.length(); i++)
+    K[cipherLinears[k++]] = Cm[i];
+  for (long i = 0; i < CRj.length(); i++)
+    K[cipherLinears[k++]] = CRj[i];
+  for (long i = 0; i < Cm_.length(); i++)
+    K[cipherLinears[k++]] = Cm_[i];
+  for (size_t j = 0; j < rangeProofCount; j++)
+    K[rangeLinears[j]] = Lj[j];
+
+  // w_q,a: SUM( lj * bri ) of each range proof
+  auto ONE = conv<ZZ_p>(1);
+  vector<WireMat::Cell> cells;
+  for (size_t j = 0; j < rangeProofCount; j++)
+  {
+    for (size_t b = 0; b < bits; b++)
+    {
+      auto jir = j * bits + b;
+      if ((Ljir[jir >> 3] >> (jir & 7)) & 1)
+        cells.push_back({rangeLinears[j], bitGates[b], ONE});
+    }
+  }
+  verifier->WqaPatch = make_shared<WireMat>(cells, verifier->m, verifier->n);
+
+  return verifier;
+}
+
+bool VerifierKey::verify(const Proof &proof,
+                         const shared_ptr<PolynomialCommitment> &commitScheme,
+                         Latency *latency) const
+{
+  size_t batchCount = cipherLinears.size() - msgCount - rangeProofCount;
+  if (proof.Cm.length() != msgCount || proof.Cm_.length() != batchCount ||
+      proof.CRj.length() != rangeProofCount || proof.Lj.length() != rangeProofCount)
+    return false;
+
+  auto t0 = chrono::steady_clock::now();
+  size_t len = (msgCount * slotsPerMsg * rangeProofCount + 7) / 8;
+  auto Ljir = CBatchEnc::calculateLjir(proof.Cm, proof.Cm_, proof.CRj, len);
+  auto verifier = generateVerifier(proof.Cm, proof.Cm_, proof.CRj, Ljir, proof.Lj, commitScheme);
+
+  auto t1 = chrono::steady_clock::now();
+  bool ret = verifier->verify(proof.commits, proof.pc, proof.proofs);
+
+  auto t2 = chrono::steady_clock::now();
+  if (latency)
+  {
+    latency->circuit = chrono::duration<double>(t1 - t0).count();
+    latency->verify = chrono::duration<double>(t2 - t1).count();
+  }
+  return ret;
+}
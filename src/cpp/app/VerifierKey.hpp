@@ -0,0 +1,205 @@
+#pragma once
+
+#include "./namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+
+#include "./CBatchEnc.hpp"
+#include "./CircuitZKPVerifier.hpp"
+#include "./PaillierEncryption.hpp"
+#include "./PolynomialCommitment.hpp"
+#include "./Proof.hpp"
+#include "./math/WireMat.hpp"
+#include "./utils/SectionFile.hpp"
+
+namespace polyu
+{
+
+/**
+ * @brief _VerifierKey_ is the preprocessed verifier side of a _CBatchEnc_ circuit. The circuit structure only depends on the public key and the settings (msgCount, rangeProofCount, slotSize, msgPerBatch), so it is wired up once with zero ciphertexts and challenges (the static part). Per proof, the ciphertexts and L_j are patched into K_q and the rows of L_j,i,r * b_i,r are added on top of w_q,a (the dynamic part), without wiring up the circuit again.
+ *
+ * The static part is saved as a _SectionFile_ with magic "ZKPVRKEY". The wire coefficients are stored as indices into a table of distinct values, so the file stays small and loading does not parse big integers per entry.
+ */
+class VerifierKey
+{
+private:
+  ZZ pk;
+  ZZ GP_Q;
+  ZZ GP_P;
+  ZZ_p GP_G;
+
+  size_t msgCount;
+  size_t rangeProofCount;
+  size_t slotSize;
+  size_t msgPerBatch;
+  size_t slotsPerMsg;
+
+  shared_ptr<const WireMat> Wqa;
+  shared_ptr<const WireMat> Wqb;
+  shared_ptr<const WireMat> Wqc;
+  Vec<ZZ_p> Kq;
+
+  vector<size_t> cipherLinears; // linear constrains of the ciphertexts, in order of Cm, CRj, Cm_
+  vector<size_t> rangeLinears;  // linear constrains of the range proofs
+  vector<size_t> bitGates;      // gate of b_i,r after layout, indexed by i * slotsPerMsg + r
+
+public:
+  static const uint32_t VERSION = 1;
+
+  static const uint32_t SECTION_GROUP = 1;
+  static const uint32_t SECTION_SETTINGS = 2;
+  static const uint32_t SECTION_VALUES = 3;
+  static const uint32_t SECTION_KQ = 4;
+  static const uint32_t SECTION_ROWS = 5;
+  static const uint32_t SECTION_ENTRIES = 6;
+  static const uint32_t SECTION_CIPHERS = 7;
+  static const uint32_t SECTION_RANGES = 8;
+  static const uint32_t SECTION_BITS = 9;
+
+  /**
+   * @brief Per-phase latency of a verification (in second)
+   */
+  struct Latency
+  {
+    double circuit = 0; // derive L_j,i,r and patch the circuit
+    double verify = 0;  // check the commitments and proofs
+  };
+
+  /**
+   * @brief Preprocess the verifier key of a circuit
+   *
+   * @param crypto PaillierEncryption object, only the public elements are used
+   * @param msgCount Total messages count
+   * @param rangeProofCount Total range proof count
+   * @param slotSize Message's slot size (in byte)
+   * @param msgPerBatch Messages per batch
+   */
+  VerifierKey(const shared_ptr<PaillierEncryption> &crypto,
+              size_t msgCount, size_t rangeProofCount = 2,
+              size_t slotSize = 4, size_t msgPerBatch = 15);
+
+  /**
+   * @brief Load a verifier key file, the file is mapped and the data checksums are validated
+   *
+   * @param path File path
+   */
+  VerifierKey(const string &path);
+
+  /**
+   * @brief Write the static part to a file
+   *
+   * @param path File path
+   */
+  void save(const string &path) const;
+
+  /**
+   * @brief Whether the key is for the public key, group and circuit settings
+   *
+   * @param pk Public key
+   * @param GP_Q Group element Q
+   * @param GP_P Group element p
+   * @param GP_G Group generator g
+   * @param msgCount Total messages count
+   * @param rangeProofCount Total range proof count
+   * @param slotSize Slot size (in byte)
+   * @param msgPerBatch Number of message per batch
+   * @return true
+   * @return false
+   */
+  bool matches(const ZZ &pk, const ZZ &GP_Q, const ZZ &GP_P, const ZZ_p &GP_G,
+               size_t msgCount, size_t rangeProofCount, size_t slotSize, size_t msgPerBatch) const;
+
+  /**
+   * @brief Whether the commitment scheme is over the group of the key
+   *
+   * @param commitScheme Polynomial commitment scheme
+   * @return true
+   * @return false
+   */
+  bool matches(const PolynomialCommitment &commitScheme) const;
+
+  /**
+   * @brief Get the public key
+   *
+   * @return ZZ
+   */
+  ZZ getPublicKey() const;
+
+  /**
+   * @brief Get the group element Q
+   *
+   * @return ZZ
+   */
+  ZZ getGroupQ() const;
+
+  /**
+   * @brief Get the group element p
+   *
+   * @return ZZ
+   */
+  ZZ getGroupP() const;
+
+  /**
+   * @brief Matrix size m
+   *
+   * @return size_t
+   */
+  size_t getM() const;
+
+  /**
+   * @brief Matrix size n
+   *
+   * @return size_t
+   */
+  size_t getN() const;
+
+  /**
+   * @brief Linear constrains count (Q)
+   *
+   * @return size_t
+   */
+  size_t getQ() const;
+
+  /**
+   * @brief Largest size of a serialized proof for the key, eg. to bound the frames read from a socket
+   *
+   * @return size_t Number of bytes
+   */
+  size_t proofBytes() const;
+
+  /**
+   * @brief Generate the verifier of a proof, the static wires are shared with the key. The verifier takes the thread budget of the commitment scheme
+   *
+   * @param Cm Ciphertexts of messages
+   * @param Cm_ Ciphertexts of auxiliary messages
+   * @param CRj Ciphertexts of range proof masks
+   * @param Ljir Challenge value L_j,i,r
+   * @param Lj Challenge response (L_j = l * b + R_j) for range proof
+   * @param commitScheme Polynomial commitment scheme, it can be shared between verifiers
+   * @return shared_ptr<CircuitZKPVerifier>
+   */
+  shared_ptr<CircuitZKPVerifier> generateVerifier(
+      const Vec<ZZ_p> &Cm,
+      const Vec<ZZ_p> &Cm_,
+      const Vec<ZZ_p> &CRj,
+      const binary_t &Ljir,
+      const Vec<ZZ_p> &Lj,
+      const shared_ptr<PolynomialCommitment> &commitScheme) const;
+
+  /**
+   * @brief Verify a proof. The challenges are derived from the proof and nothing is kept between calls, so many threads can verify with the same key and commitment scheme at once
+   *
+   * @param proof The proof
+   * @param commitScheme Polynomial commitment scheme
+   * @param latency Optional, set to the time spent in each phase
+   * @return true
+   * @return false
+   */
+  bool verify(const Proof &proof,
+              const shared_ptr<PolynomialCommitment> &commitScheme,
+              Latency *latency = nullptr) const;
+};
+
+} // namespace polyu
@@ -0,0 +1,108 @@
+#include "./CompactMat.hpp"
+
+CompactMat::CompactMat() {}
+
+CompactMat::CompactMat(const Mat<ZZ_p> &mat, const ZZ &modulus)
+{
+  m = mat.NumRows();
+  n = mat.NumCols();
+  cells.assign(m * n, 0);
+  full.assign(m * n, false);
+
+  for (size_t i = 0; i < m; i++)
+  {
+    for (size_t j = 0; j < n; j++)
+      set(i * n + j, rep(mat[i][j]), modulus);
+  }
+}
+
+CompactMat::CompactMat(const Matrix &mat, const ZZ &modulus)
+{
+  m = mat.m;
+  n = mat.n;
+  cells.assign(m * n, 0);
+  full.assign(m * n, false);
+
+  for (size_t i = 0; i < m; i++)
+  {
+    for (auto &it : mat.values[i])
+      set(i * n + it.first, rep(it.second), modulus);
+  }
+}
+
+void CompactMat::set(size_t k, const ZZ &x, const ZZ &modulus)
+{
+  if (IsZero(x))
+    return;
+
+  if (NumBits(x) <= SMALL_BITS)
+  {
+    cells[k] = conv<long>(x);
+    return;
+  }
+
+  ZZ neg = modulus - x;
+  if (NumBits(neg) <= SMALL_BITS)
+  {
+    cells[k] = -conv<long>(neg);
+    return;
+  }
+
+  cells[k] = large.length();
+  full[k] = true;
+  large.append(x);
+}
+
+long CompactMat::NumRows() const
+{
+  return m;
+}
+
+long CompactMat::NumCols() const
+{
+  return n;
+}
+
+size_t CompactMat::fullCount() const
+{
+  return large.length();
+}
+
+ZZ_p CompactMat::get(size_t i, size_t j) const
+{
+  if (i >= m || j >= n)
+    throw invalid_argument("index out of range");
+
+  size_t k = i * n + j;
+  return full[k] ? conv<ZZ_p>(large[cells[k]]) : conv<ZZ_p>(cells[k]);
+}
+
+void CompactMat::row(size_t i, Vec<ZZ_p> &ret) const
+{
+  ret.SetLength(n);
+  for (size_t j = 0; j < n; j++)
+    ret[j] = get(i, j);
+}
+
+void CompactMat::exponents(size_t i, Vec<ZZ> &ret) const
+{
+  if (i >= m)
+    throw invalid_argument("index out of range");
+
+  ret.SetLength(n);
+  for (size_t j = 0; j < n; j++)
+  {
+    size_t k = i * n + j;
+    if (full[k])
+      ret[j] = large[cells[k]];
+    else
+      conv(ret[j], cells[k]);
+  }
+}
+
+void CompactMat::toMat(Mat<ZZ_p> &ret) const
+{
+  ret.SetDims(m, n);
+  for (size_t i = 0; i < m; i++)
+    row(i, ret[i]);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "../namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+#include <NTL/matrix.h>
+
+#include "./Matrix.hpp"
+
+namespace polyu
+{
+
+/**
+ * @brief _CompactMat_ is a dense matrix over Z_p which keeps small values, including small negative values (v = p - |v|), inline as machine words. Only full width values are kept as big integers, so witness matrices which are mostly 0, 1 and -1 take a few bytes per cell instead of a full _ZZ_p_.
+ */
+class CompactMat
+{
+private:
+  size_t m = 0;
+  size_t n = 0;
+
+  /// @brief Signed value of small cells, or the index in large of full width cells
+  vector<int64_t> cells;
+
+  /// @brief Flags of full width cells
+  vector<bool> full;
+
+  /// @brief Full width values
+  Vec<ZZ> large;
+
+  void set(size_t k, const ZZ &x, const ZZ &modulus);
+
+public:
+  /// @brief Max length of small values in bits
+  static const long SMALL_BITS = 62;
+
+  CompactMat();
+
+  /**
+   * @brief Construct from a dense matrix
+   *
+   * @param mat Matrix, under modulus
+   * @param modulus
+   */
+  CompactMat(const Mat<ZZ_p> &mat, const ZZ &modulus);
+
+  /**
+   * @brief Construct from a sparse matrix
+   *
+   * @param mat Matrix, under modulus
+   * @param modulus
+   */
+  CompactMat(const Matrix &mat, const ZZ &modulus);
+
+  long NumRows() const;
+  long NumCols() const;
+
+  /**
+   * @brief Number of cells stored as big integers
+   *
+   * @return size_t
+   */
+  size_t fullCount() const;
+
+  /**
+   * @brief Get a cell (0-based), under the current ZZ_p modulus
+   *
+   * @param i Row
+   * @param j Column
+   * @return ZZ_p
+   */
+  ZZ_p get(size_t i, size_t j) const;
+
+  /**
+   * @brief Get a row (0-based), under the current ZZ_p modulus
+   *
+   * @param i Row
+   * @param ret Result
+   */
+  void row(size_t i, Vec<ZZ_p> &ret) const;
+
+  /**
+   * @brief Get a row (0-based) as signed integers, small negative values are negative and full width values are in [0, p)
+   *
+   * @param i Row
+   * @param ret Result
+   */
+  void exponents(size_t i, Vec<ZZ> &ret) const;
+
+  /**
+   * @brief Convert to a dense matrix, under the current ZZ_p modulus
+   *
+   * @param ret Result
+   */
+  void toMat(Mat<ZZ_p> &ret) const;
+};
+
+} // namespace polyu
@@ -0,0 +1,107 @@
+#include "./FixedBase.hpp"
+
+FixedBase::FixedBase() {}
+
+FixedBase::FixedBase(const ZZ &base, const ZZ &modulus, long maxBits, long window)
+{
+  if (modulus <= 1)
+    throw invalid_argument("modulus must be greater than 1");
+
+  this->modulus = modulus;
+  rem(this->base, base, modulus);
+  this->window = window > 0 ? window : 4;
+  this->maxBits = maxBits;
+
+  long digits = 1L << this->window;
+  long rows = (maxBits + this->window - 1) / this->window;
+  tbl.SetLength(rows);
+
+  ZZ x = this->base;
+  for (long i = 0; i < rows; i++)
+  {
+    // [x, x^2, ..., x^(2^w - 1)], x = base^(2^(w * i))
+    tbl[i].SetLength(digits - 1);
+    tbl[i][0] = x;
+    for (long d = 1; d < digits - 1; d++)
+      MulMod(tbl[i][d], tbl[i][d - 1], x, modulus);
+
+    MulMod(x, tbl[i][digits - 2], x, modulus);
+  }
+}
+
+FixedBase::FixedBase(const ZZ &base, const ZZ &modulus, long maxBits, long window, const Vec<ZZ> &table)
+{
+  if (modulus <= 1 || window <= 0)
+    throw invalid_argument("invalid fixed base parameters");
+
+  this->modulus = modulus;
+  rem(this->base, base, modulus);
+  this->window = window;
+  this->maxBits = maxBits;
+
+  long digits = (1L << window) - 1;
+  long rows = (maxBits + window - 1) / window;
+  if (table.length() != rows * digits)
+    throw invalid_argument("table size does not match with the parameters");
+
+  tbl.SetLength(rows);
+  for (long i = 0; i < rows; i++)
+  {
+    tbl[i].SetLength(digits);
+    for (long d = 0; d < digits; d++)
+      tbl[i][d] = table[i * digits + d];
+  }
+}
+
+void FixedBase::power(ZZ &ret, const ZZ &a) const
+{
+  if (a < 0)
+    throw invalid_argument("exponent must be non-negative");
+
+  if (NumBits(a) > maxBits)
+  {
+    PowerMod(ret, base, a, modulus);
+    return;
+  }
+
+  ZZ acc(1);
+  bool first = true;
+  long bits = NumBits(a);
+  for (long i = 0; i * window < bits; i++)
+  {
+    long d = 0;
+    for (long k = window - 1; k >= 0; k--)
+      d = (d << 1) | bit(a, i * window + k);
+    if (d == 0)
+      continue;
+
+    if (first)
+      acc = tbl[i][d - 1];
+    else
+      MulMod(acc, acc, tbl[i][d - 1], modulus);
+    first = false;
+  }
+
+  if (first)
+    rem(acc, acc, modulus);
+  ret = acc;
+}
+
+ZZ FixedBase::power(const ZZ &a) const
+{
+  ZZ ret;
+  power(ret, a);
+  return ret;
+}
+
+long FixedBase::tableSize() const
+{
+  return tbl.length() * ((1L << window) - 1);
+}
+
+void FixedBase::toVec(Vec<ZZ> &ret) const
+{
+  ret.SetLength(0);
+  for (long i = 0; i < tbl.length(); i++)
+    ret.append(tbl[i]);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+
+namespace polyu
+{
+
+/**
+ * @brief _FixedBase_ keeps precomputed powers of a fixed base, base^(d * 2^(w * i)) for every window digit d, so an exponentiation with a bounded exponent only takes one modular multiplication per window.
+ */
+class FixedBase
+{
+private:
+  /// @brief tbl[i][d - 1] = base^(d * 2^(window * i)) mod modulus
+  Vec<Vec<ZZ>> tbl;
+
+public:
+  /// @brief The fixed base
+  ZZ base;
+
+  /// @brief The modulus
+  ZZ modulus;
+
+  /// @brief Window size
+  long window = 4;
+
+  /// @brief Max exponent length covered by the table, longer exponents fall back to PowerMod
+  long maxBits = 0;
+
+  FixedBase();
+
+  /**
+   * @brief Precompute the table of a fixed base
+   *
+   * @param base Base
+   * @param modulus
+   * @param maxBits Max exponent length in bits
+   * @param window Window size, 0 means default (4)
+   */
+  FixedBase(const ZZ &base, const ZZ &modulus, long maxBits, long window = 0);
+
+  /**
+   * @brief Import a precomputed table, eg. from a parameter bundle
+   *
+   * @param base Base
+   * @param modulus
+   * @param maxBits Max exponent length in bits
+   * @param window Window size
+   * @param table Flattened table, in the order of toVec
+   */
+  FixedBase(const ZZ &base, const ZZ &modulus, long maxBits, long window, const Vec<ZZ> &table);
+
+  /**
+   * @brief Calculate base^a mod modulus
+   *
+   * @param ret Result
+   * @param a Non-negative exponent
+   */
+  void power(ZZ &ret, const ZZ &a) const;
+
+  /**
+   * @brief Calculate base^a mod modulus
+   *
+   * @param a Non-negative exponent
+   * @return ZZ
+   */
+  ZZ power(const ZZ &a) const;
+
+  /**
+   * @brief Number of precomputed elements
+   *
+   * @return long
+   */
+  long tableSize() const;
+
+  /**
+   * @brief Export the flattened table, row by row
+   *
+   * @param ret Result
+   */
+  void toVec(Vec<ZZ> &ret) const;
+};
+
+} // namespace polyu
@@ -120,6 +120,22 @@ shared_ptr<Matrix> Matrix::group(size_t newN, size_t newM)
   return ret;
 }
 
+shared_ptr<Matrix> Matrix::permute(const vector<size_t> &position)
+{
+  if (m != 1)
+    throw invalid_argument("only allow permute a vector");
+  if (n > position.size())
+    throw invalid_argument("cannot permute a big vector with a short position list");
+
+  auto ret = make_shared<Matrix>(1, position.size());
+  for (auto it : values[0])
+  {
+    ret->cell(0, position[it.first], it.second);
+  }
+
+  return ret;
+}
+
 void Matrix::shift(size_t n)
 {
   if (n == 0)
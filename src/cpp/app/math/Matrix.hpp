@@ -36,6 +36,7 @@ public:
   void toMat(Mat<ZZ_p> &output);
 
   shared_ptr<Matrix> group(size_t n, size_t m = 0);
+  shared_ptr<Matrix> permute(const vector<size_t> &position); // cell i moves to position[i]
 
   void shift(size_t n);
   void extend(size_t n);
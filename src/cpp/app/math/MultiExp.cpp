@@ -0,0 +1,178 @@
+#include "./MultiExp.hpp"
+
+#include "../utils/Parallel.hpp"
+
+namespace
+{
+// c-bit digits of an exponent, least significant first, decoded once from its bytes
+void decompose(vector<uint16_t> &digits, const ZZ &e, long c, long windows, binary_t &bytes)
+{
+  long len = NumBytes(e);
+  bytes.assign(len + 3, 0);
+  BytesFromZZ(bytes.data(), e, len);
+
+  digits.resize(windows);
+  for (long w = 0; w < windows; w++)
+  {
+    long pos = w * c;
+    // c <= 16, a digit spans at most 3 bytes
+    uint32_t v = 0;
+    long byte = pos >> 3;
+    if (byte < len)
+      v = bytes[byte] | (bytes[byte + 1] << 8) | (bytes[byte + 2] << 16);
+    digits[w] = (v >> (pos & 7)) & ((1U << c) - 1);
+  }
+}
+
+// prod(bases[i]^exps[i]) for i in [begin, end)
+void pippenger(ZZ &ret, const Vec<ZZ> &bases, const Vec<ZZ> &exps, const ZZ &modulus, size_t begin, size_t end)
+{
+  long bits = 0;
+  for (size_t i = begin; i < end; i++)
+    bits = max(bits, NumBits(exps[i]));
+
+  ZZ acc(1);
+  if (bits == 0)
+  {
+    rem(ret, acc, modulus);
+    return;
+  }
+
+  long c = MultiExp::optimalWindow(end - begin, bits);
+  long windows = (bits + c - 1) / c;
+  long digits = 1L << c;
+
+  // digit decomposition of every exponent, [i - begin][w]
+  vector<vector<uint16_t>> table(end - begin);
+  binary_t bytes;
+  for (size_t i = begin; i < end; i++)
+    decompose(table[i - begin], exps[i], c, windows, bytes);
+
+  // buckets are reused by every window
+  vector<ZZ> buckets(digits);
+  vector<bool> used(digits);
+  ZZ running, total;
+
+  for (long w = windows - 1; w >= 0; w--)
+  {
+    // Horner, acc = acc^(2^c)
+    if (w != windows - 1)
+    {
+      for (long k = 0; k < c; k++)
+        SqrMod(acc, acc, modulus);
+    }
+
+    fill(used.begin(), used.end(), false);
+    for (size_t i = begin; i < end; i++)
+    {
+      long d = table[i - begin][w];
+      if (d == 0)
+        continue;
+
+      if (used[d])
+        MulMod(buckets[d], buckets[d], bases[i], modulus);
+      else
+        rem(buckets[d], bases[i], modulus);
+      used[d] = true;
+    }
+
+    // prod(bucket[d]^d) = prod of the running suffix products
+    bool started = false;
+    bool any = false;
+    for (long d = digits - 1; d > 0; d--)
+    {
+      if (used[d])
+      {
+        if (started)
+          MulMod(running, running, buckets[d], modulus);
+        else
+          running = buckets[d];
+        started = true;
+      }
+      if (!started)
+        continue;
+
+      if (any)
+        MulMod(total, total, running, modulus);
+      else
+        total = running;
+      any = true;
+    }
+
+    if (any)
+      MulMod(acc, acc, total, modulus);
+  }
+
+  rem(ret, acc, modulus);
+}
+} // namespace
+
+long MultiExp::optimalWindow(size_t n, long bits)
+{
+  // cost ~ bits / c * (n + 2^(c+1)) multiplications
+  long best = 1;
+  double bestCost = -1;
+  for (long c = 1; c <= MAX_WINDOW; c++)
+  {
+    double cost = ceil(bits * 1.0 / c) * (n + (2.0 * (1L << c)));
+    if (bestCost < 0 || cost < bestCost)
+    {
+      best = c;
+      bestCost = cost;
+    }
+  }
+  return best;
+}
+
+void MultiExp::power(ZZ &ret, const Vec<ZZ> &bases, const Vec<ZZ> &exps, const ZZ &modulus, size_t threads)
+{
+  if (bases.length() != exps.length())
+    throw invalid_argument("number of bases and exponents do not match");
+  for (long i = 0; i < exps.length(); i++)
+  {
+    if (exps[i] < 0)
+      throw invalid_argument("exponent must be non-negative");
+  }
+
+  size_t n = bases.length();
+  threads = Parallel::threadCount(threads, n);
+
+  // split the bases into chunks, the partial products are combined in order
+  Vec<ZZ> partials;
+  partials.SetLength(threads);
+  Parallel::forRange(threads, [&](size_t tb, size_t te) {
+    for (size_t t = tb; t < te; t++)
+    {
+      size_t begin = n * t / threads;
+      size_t end = n * (t + 1) / threads;
+      pippenger(partials[t], bases, exps, modulus, begin, end);
+    }
+  }, threads);
+
+  ZZ acc(1);
+  for (size_t t = 0; t < threads; t++)
+    MulMod(acc, acc, partials[t], modulus);
+  rem(ret, acc, modulus);
+}
+
+ZZ_p MultiExp::power(const Vec<ZZ_p> &bases, const Vec<ZZ> &exps, size_t threads)
+{
+  Vec<ZZ> bs;
+  bs.SetLength(bases.length());
+  for (long i = 0; i < bases.length(); i++)
+    bs[i] = rep(bases[i]);
+
+  ZZ ret;
+  power(ret, bs, exps, ZZ_p::modulus(), threads);
+  return conv<ZZ_p>(ret);
+}
+
+ZZ_p MultiExp::power(const Vec<ZZ_p> &bases, const Vec<ZZ_p> &exps, size_t threads)
+{
+  Vec<ZZ> es;
+  es.SetLength(exps.length());
+  for (long i = 0; i < exps.length(); i++)
+    es[i] = rep(exps[i]);
+
+  return power(bases, es, threads);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+#include <NTL/vector.h>
+
+namespace polyu
+{
+
+/**
+ * @brief _MultiExp_ computes products of powers prod(bases[i]^exps[i]) with the bucket (Pippenger) method, the bases can be split into chunks that run concurrently
+ */
+class MultiExp
+{
+public:
+  /**
+   * @brief Choose the window size for a multi-exponentiation
+   *
+   * @param n Number of bases
+   * @param bits Max exponent length in bits
+   * @return long
+   */
+  static long optimalWindow(size_t n, long bits);
+
+  /// @brief Max window size
+  static const long MAX_WINDOW = 16;
+
+  /**
+   * @brief Calculate prod(bases[i]^exps[i]) mod modulus
+   *
+   * @param ret Result
+   * @param bases Bases
+   * @param exps Non-negative exponents
+   * @param modulus
+   * @param threads Number of threads, 0 means use the default thread budget
+   */
+  static void power(ZZ &ret, const Vec<ZZ> &bases, const Vec<ZZ> &exps, const ZZ &modulus, size_t threads = 0);
+
+  /**
+   * @brief Calculate prod(bases[i]^exps[i]) under the current ZZ_p modulus
+   *
+   * @param bases Bases
+   * @param exps Non-negative exponents
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return ZZ_p
+   */
+  static ZZ_p power(const Vec<ZZ_p> &bases, const Vec<ZZ> &exps, size_t threads = 0);
+
+  /**
+   * @brief Calculate prod(bases[i]^exps[i]) under the current ZZ_p modulus, the exponents are taken by their representatives
+   *
+   * @param bases Bases
+   * @param exps Exponents
+   * @param threads Number of threads, 0 means use the default thread budget
+   * @return ZZ_p
+   */
+  static ZZ_p power(const Vec<ZZ_p> &bases, const Vec<ZZ_p> &exps, size_t threads = 0);
+};
+
+} // namespace polyu
@@ -0,0 +1,162 @@
+#include "./WireMat.hpp"
+
+#include <algorithm>
+
+WireMat::WireMat()
+{
+  offsets.assign(1, 0);
+}
+
+WireMat::WireMat(const vector<shared_ptr<Matrix>> &source, size_t m, size_t n, size_t threads)
+{
+  this->m = m;
+  this->n = n;
+
+  for (auto &w : source)
+  {
+    if (w->m == 1 && w->n > m * n)
+      throw invalid_argument("wire convert failed, N exceed the matrix dimension");
+  }
+
+  // visit the cells of constrain q in row i, in column order
+  auto visit = [&](size_t q, size_t i, const function<void(size_t j, const ZZ_p &v)> &fn) {
+    auto &w = source[q];
+    if (w->m == 1)
+    {
+      auto &cells = w->values[0];
+      for (auto it = cells.lower_bound(i * n); it != cells.end() && it->first < (i + 1) * n; it++)
+        fn(it->first - i * n, it->second);
+    }
+    else if (w->rowExists(i))
+    {
+      for (auto &it : w->values[i])
+        fn(it.first, it.second);
+    }
+  };
+
+  // count the entries of each row, then fill the rows in place
+  vector<size_t> counts(m, 0);
+  Parallel::forRange(m, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      for (size_t q = 0; q < source.size(); q++)
+        visit(q, i, [&](size_t j, const ZZ_p &v) {
+          if (!IsZero(v))
+            counts[i]++;
+        });
+    }
+  }, threads);
+
+  offsets.assign(m + 1, 0);
+  for (size_t i = 0; i < m; i++)
+    offsets[i + 1] = offsets[i] + counts[i];
+  entries.resize(offsets[m]);
+
+  Parallel::forRange(m, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++)
+    {
+      size_t k = offsets[i];
+      for (size_t q = 0; q < source.size(); q++)
+        visit(q, i, [&](size_t j, const ZZ_p &v) {
+          if (IsZero(v))
+            return;
+          entries[k].q = q;
+          entries[k].j = j;
+          entries[k].v = v;
+          k++;
+        });
+    }
+  }, threads);
+}
+
+WireMat::WireMat(const vector<Cell> &cells, size_t m, size_t n)
+{
+  this->m = m;
+  this->n = n;
+
+  vector<size_t> counts(m, 0);
+  for (auto &c : cells)
+  {
+    if (c.k >= m * n)
+      throw invalid_argument("wire convert failed, N exceed the matrix dimension");
+    if (!IsZero(c.v))
+      counts[c.k / n]++;
+  }
+
+  offsets.assign(m + 1, 0);
+  for (size_t i = 0; i < m; i++)
+    offsets[i + 1] = offsets[i] + counts[i];
+  entries.resize(offsets[m]);
+
+  vector<size_t> next(offsets.begin(), offsets.end() - 1);
+  for (auto &c : cells)
+  {
+    if (IsZero(c.v))
+      continue;
+    auto &e = entries[next[c.k / n]++];
+    e.q = c.q;
+    e.j = c.k % n;
+    e.v = c.v;
+  }
+
+  for (size_t i = 0; i < m; i++)
+  {
+    sort(entries.begin() + offsets[i], entries.begin() + offsets[i + 1], [](const Entry &a, const Entry &b) {
+      return a.q < b.q || (a.q == b.q && a.j < b.j);
+    });
+  }
+}
+
+WireMat::WireMat(size_t m, size_t n, vector<size_t> offsets, vector<Entry> entries)
+{
+  if (offsets.size() != m + 1 || offsets[0] != 0 || offsets[m] != entries.size())
+    throw invalid_argument("invalid wire row offsets");
+  for (size_t i = 0; i < m; i++)
+  {
+    if (offsets[i] > offsets[i + 1])
+      throw invalid_argument("invalid wire row offsets");
+  }
+  for (auto &e : entries)
+  {
+    if (e.j >= n)
+      throw invalid_argument("invalid wire entry, column out of range");
+  }
+
+  this->m = m;
+  this->n = n;
+  this->offsets = move(offsets);
+  this->entries = move(entries);
+}
+
+long WireMat::NumRows() const
+{
+  return m;
+}
+
+long WireMat::NumCols() const
+{
+  return n;
+}
+
+size_t WireMat::size() const
+{
+  return entries.size();
+}
+
+WireMat::Row WireMat::row(size_t i) const
+{
+  if (i >= m)
+    throw invalid_argument("index out of range");
+
+  return {entries.data() + offsets[i], entries.data() + offsets[i + 1]};
+}
+
+const vector<size_t> &WireMat::getOffsets() const
+{
+  return offsets;
+}
+
+const vector<WireMat::Entry> &WireMat::getEntries() const
+{
+  return entries;
+}
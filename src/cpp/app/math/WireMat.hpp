@@ -0,0 +1,126 @@
+#pragma once
+
+#include "../namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/ZZ_p.h>
+
+#include "./Matrix.hpp"
+#include "../utils/Parallel.hpp"
+
+namespace polyu
+{
+
+/**
+ * @brief _WireMat_ stores the linear constrains w_q of a circuit in compressed sparse rows. Row i keeps the nonzero entries (q, j, w_q[i][j]) of all constrains in one contiguous array sorted by (q, j), so a row is walked without lookups or allocation.
+ */
+class WireMat
+{
+public:
+  /**
+   * @brief Nonzero entry of row i, the coefficient of constrain q at column j
+   */
+  struct Entry
+  {
+    size_t q;
+    size_t j;
+    ZZ_p v;
+  };
+
+  /**
+   * @brief Nonzero coefficient of constrain q at gate k, gate k is at row k / n and column k % n
+   */
+  struct Cell
+  {
+    size_t q;
+    size_t k;
+    ZZ_p v;
+  };
+
+  /**
+   * @brief View of the entries of a row
+   */
+  struct Row
+  {
+    const Entry *first;
+    const Entry *last;
+
+    const Entry *begin() const { return first; }
+    const Entry *end() const { return last; }
+    size_t size() const { return last - first; }
+  };
+
+private:
+  size_t m = 0;
+  size_t n = 0;
+
+  /// @brief Entries of row i are in [offsets[i], offsets[i + 1])
+  vector<size_t> offsets;
+  vector<Entry> entries;
+
+public:
+  WireMat();
+
+  /**
+   * @brief Construct from the constrains w_q, rows are built concurrently. A constrain with a single row is taken as a gate vector, gate k goes to row k / n and column k % n, otherwise the constrain is already grouped to m x n
+   *
+   * @param source Constrains w_q
+   * @param m Matrix size m
+   * @param n Matrix size n
+   * @param threads Number of threads, 0 means use the default thread budget
+   */
+  WireMat(const vector<shared_ptr<Matrix>> &source, size_t m, size_t n, size_t threads = 0);
+
+  /**
+   * @brief Construct from a list of gate coefficients, used for the few entries which change per proof
+   *
+   * @param cells Coefficients, each (q, k) appears at most once
+   * @param m Matrix size m
+   * @param n Matrix size n
+   */
+  WireMat(const vector<Cell> &cells, size_t m, size_t n);
+
+  /**
+   * @brief Construct from the row offsets and the entries, eg. loaded from a file
+   *
+   * @param m Matrix size m
+   * @param n Matrix size n
+   * @param offsets Entries of row i are in [offsets[i], offsets[i + 1])
+   * @param entries Entries sorted by (q, j) in each row
+   */
+  WireMat(size_t m, size_t n, vector<size_t> offsets, vector<Entry> entries);
+
+  long NumRows() const;
+  long NumCols() const;
+
+  /**
+   * @brief Number of nonzero entries
+   *
+   * @return size_t
+   */
+  size_t size() const;
+
+  /**
+   * @brief Get the entries of a row (0-based)
+   *
+   * @param i Row
+   * @return Row
+   */
+  Row row(size_t i) const;
+
+  /**
+   * @brief Row offsets, entries of row i are in [offsets[i], offsets[i + 1])
+   *
+   * @return const vector<size_t>&
+   */
+  const vector<size_t> &getOffsets() const;
+
+  /**
+   * @brief All entries in row order
+   *
+   * @return const vector<Entry>&
+   */
+  const vector<Entry> &getEntries() const;
+};
+
+} // namespace polyu
@@ -0,0 +1,79 @@
+#include "./Parallel.hpp"
+
+size_t Parallel::defaultThreads = 0;
+
+size_t Parallel::threadCount(size_t threads, size_t n)
+{
+  if (threads == 0)
+    threads = defaultThreads;
+  if (threads == 0)
+    threads = thread::hardware_concurrency();
+  if (threads == 0)
+    threads = 1;
+  if (n > 0 && threads > n)
+    threads = n;
+  return threads;
+}
+
+void Parallel::forRange(size_t n, const function<void(size_t begin, size_t end)> &fn, size_t threads)
+{
+  if (n == 0)
+    return;
+
+  threads = threadCount(threads, n);
+  if (threads == 1)
+  {
+    fn(0, n);
+    return;
+  }
+
+  // ZZ_p modulus is thread local, pass the caller's one to the workers
+  ZZ_pContext context;
+  context.save();
+
+  vector<exception_ptr> errors(threads);
+  vector<thread> workers;
+  size_t chunk = n / threads;
+  size_t extra = n % threads;
+  size_t begin = 0;
+
+  for (size_t t = 0; t < threads; t++)
+  {
+    size_t end = begin + chunk + (t < extra ? 1 : 0);
+    if (t == threads - 1)
+    {
+      // the last chunk runs on the caller thread
+      try
+      {
+        fn(begin, end);
+      }
+      catch (...)
+      {
+        errors[t] = current_exception();
+      }
+      break;
+    }
+
+    workers.push_back(thread([&, t, begin, end]() {
+      try
+      {
+        context.restore();
+        fn(begin, end);
+      }
+      catch (...)
+      {
+        errors[t] = current_exception();
+      }
+    }));
+    begin = end;
+  }
+
+  for (auto &w : workers)
+    w.join();
+
+  for (auto &e : errors)
+  {
+    if (e)
+      rethrow_exception(e);
+  }
+}
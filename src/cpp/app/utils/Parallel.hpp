@@ -0,0 +1,40 @@
+#pragma once
+
+#include "../namespace.hpp"
+
+#include <thread>
+#include <functional>
+#include <exception>
+
+#include <NTL/ZZ_p.h>
+
+namespace polyu
+{
+
+class Parallel
+{
+public:
+  /// @brief Default thread budget, 0 means use all hardware threads
+  static size_t defaultThreads;
+
+  /**
+   * @brief Resolve the number of threads to use
+   *
+   * @param threads Requested threads, 0 means use the default thread budget
+   * @param n Number of jobs, the result never exceeds it
+   * @return size_t
+   */
+  static size_t threadCount(size_t threads = 0, size_t n = 0);
+
+  /**
+   * @brief Split the range [0, n) into contiguous chunks and run them concurrently,
+   * each worker runs under the caller's ZZ_p modulus
+   *
+   * @param n Range size
+   * @param fn Job for the chunk [begin, end)
+   * @param threads Number of threads, 0 means use the default thread budget
+   */
+  static void forRange(size_t n, const function<void(size_t begin, size_t end)> &fn, size_t threads = 0);
+};
+
+} // namespace polyu
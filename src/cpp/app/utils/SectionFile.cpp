@@ -0,0 +1,230 @@
+#include "./SectionFile.hpp"
+
+#include <fstream>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace
+{
+const size_t MAGIC_SIZE = 8;
+const size_t HEADER_SIZE = 48;
+const size_t SECTION_SIZE = 40;
+const size_t CHECKSUM_OFFSET = 24;
+} // namespace
+
+uint64_t SectionFile::checksum(const uint8_t *data, size_t length)
+{
+  // FNV-1a
+  uint64_t h = 14695981039346656037ULL;
+  for (size_t i = 0; i < length; i++)
+  {
+    h ^= data[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+void SectionFile::putU32(uint8_t *p, uint32_t v)
+{
+  for (size_t i = 0; i < 4; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+void SectionFile::putU64(uint8_t *p, uint64_t v)
+{
+  for (size_t i = 0; i < 8; i++)
+    p[i] = (uint8_t)(v >> (8 * i));
+}
+
+uint32_t SectionFile::getU32(const uint8_t *p)
+{
+  uint32_t v = 0;
+  for (size_t i = 0; i < 4; i++)
+    v |= (uint32_t)p[i] << (8 * i);
+  return v;
+}
+
+uint64_t SectionFile::getU64(const uint8_t *p)
+{
+  uint64_t v = 0;
+  for (size_t i = 0; i < 8; i++)
+    v |= (uint64_t)p[i] << (8 * i);
+  return v;
+}
+
+SectionFile::Content SectionFile::encode(uint32_t id, const Vec<ZZ> &values, uint32_t window, uint32_t maxBits)
+{
+  long elementBytes = 1;
+  for (long i = 0; i < values.length(); i++)
+    elementBytes = max(elementBytes, NumBytes(values[i]));
+
+  Content ret = {id, (uint32_t)elementBytes, binary_t(elementBytes * values.length(), 0), window, maxBits};
+  for (long i = 0; i < values.length(); i++)
+    BytesFromZZ(ret.bytes.data() + i * elementBytes, values[i], elementBytes);
+  return ret;
+}
+
+void SectionFile::write(const string &path, const string &magic, uint32_t version, const vector<Content> &contents, const string &name)
+{
+  if (magic.size() != MAGIC_SIZE)
+    throw invalid_argument("file magic must be 8 bytes");
+
+  size_t offset = HEADER_SIZE + SECTION_SIZE * contents.size();
+  size_t bodySize = 0;
+  binary_t header(offset, 0);
+
+  for (size_t k = 0; k < contents.size(); k++)
+  {
+    auto &c = contents[k];
+    if (c.elementBytes == 0 || c.bytes.size() % c.elementBytes != 0)
+      throw invalid_argument("section data is not a multiple of the element size");
+
+    uint8_t *p = header.data() + HEADER_SIZE + SECTION_SIZE * k;
+    putU32(p, c.id);
+    putU32(p + 4, c.elementBytes);
+    putU64(p + 8, c.bytes.size() / c.elementBytes);
+    putU64(p + 16, offset + bodySize);
+    putU64(p + 24, checksum(c.bytes.data(), c.bytes.size()));
+    putU32(p + 32, c.window);
+    putU32(p + 36, c.maxBits);
+    bodySize += c.bytes.size();
+  }
+
+  memcpy(header.data(), magic.data(), MAGIC_SIZE);
+  putU32(header.data() + 8, version);
+  putU32(header.data() + 12, contents.size());
+  putU64(header.data() + 16, header.size() + bodySize);
+  putU64(header.data() + CHECKSUM_OFFSET, checksum(header.data(), header.size()));
+
+  ofstream fs(path, ios::binary | ios::trunc);
+  if (!fs)
+    throw invalid_argument("cannot open " + name + " for writing: " + path);
+  fs.write((const char *)header.data(), header.size());
+  for (auto &c : contents)
+    fs.write((const char *)c.bytes.data(), c.bytes.size());
+  if (!fs)
+    throw runtime_error("failed to write " + name + ": " + path);
+}
+
+SectionFile::SectionFile(const string &path, const string &magic, uint32_t version, const string &name)
+{
+  this->name = name;
+
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw invalid_argument("cannot open " + name + ": " + path);
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < HEADER_SIZE)
+  {
+    close(fd);
+    throw invalid_argument("invalid " + name + ": " + path);
+  }
+
+  length = st.st_size;
+  void *addr = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED)
+    throw runtime_error("cannot map " + name + ": " + path);
+  data = (const uint8_t *)addr;
+
+  try
+  {
+    if (magic.size() != MAGIC_SIZE || memcmp(data, magic.data(), MAGIC_SIZE) != 0)
+      throw invalid_argument("invalid " + name + ": bad magic");
+    if (getU32(data + 8) != version)
+      throw invalid_argument("invalid " + name + ": unsupported version");
+
+    size_t count = getU32(data + 12);
+    size_t headerSize = HEADER_SIZE + SECTION_SIZE * count;
+    if (getU64(data + 16) != length || headerSize > length)
+      throw invalid_argument("invalid " + name + ": bad file size");
+
+    binary_t header(data, data + headerSize);
+    memset(header.data() + CHECKSUM_OFFSET, 0, 8);
+    if (checksum(header.data(), header.size()) != getU64(data + CHECKSUM_OFFSET))
+      throw invalid_argument("invalid " + name + ": bad header checksum");
+
+    for (size_t k = 0; k < count; k++)
+    {
+      const uint8_t *p = data + HEADER_SIZE + SECTION_SIZE * k;
+      Section s;
+      s.id = getU32(p);
+      s.elementBytes = getU32(p + 4);
+      s.count = getU64(p + 8);
+      s.offset = getU64(p + 16);
+      s.checksum = getU64(p + 24);
+      s.window = getU32(p + 32);
+      s.maxBits = getU32(p + 36);
+
+      if (s.elementBytes == 0 || s.offset < headerSize || s.offset > length ||
+          s.count > (length - s.offset) / s.elementBytes)
+        throw invalid_argument("invalid " + name + ": section out of bounds");
+      sections.push_back(s);
+    }
+  }
+  catch (...)
+  {
+    munmap((void *)data, length);
+    throw;
+  }
+}
+
+SectionFile::~SectionFile()
+{
+  if (data != nullptr)
+    munmap((void *)data, length);
+}
+
+const SectionFile::Section &SectionFile::section(uint32_t id, size_t index) const
+{
+  for (auto &s : sections)
+  {
+    if (s.id != id)
+      continue;
+    if (index == 0)
+      return s;
+    index--;
+  }
+  throw invalid_argument("section not found in " + name);
+}
+
+size_t SectionFile::sectionCount(uint32_t id) const
+{
+  size_t ret = 0;
+  for (auto &s : sections)
+  {
+    if (s.id == id)
+      ret++;
+  }
+  return ret;
+}
+
+const uint8_t *SectionFile::at(const Section &s, size_t i) const
+{
+  if (i >= s.count)
+    throw invalid_argument("element index out of range");
+
+  return data + s.offset + i * s.elementBytes;
+}
+
+ZZ SectionFile::element(const Section &s, size_t i) const
+{
+  ZZ ret;
+  ZZFromBytes(ret, at(s, i), s.elementBytes);
+  return ret;
+}
+
+bool SectionFile::verifyData() const
+{
+  for (auto &s : sections)
+  {
+    if (checksum(data + s.offset, s.count * s.elementBytes) != s.checksum)
+      return false;
+  }
+  return true;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "../namespace.hpp"
+
+#include <NTL/ZZ.h>
+#include <NTL/vector.h>
+
+namespace polyu
+{
+
+/**
+ * @brief _SectionFile_ is a read-only view of a binary file made of typed sections of fixed width elements. The file is mapped into memory and the elements are decoded on access, so processes share the pages and start without parsing the whole file.
+ *
+ * File layout (little-endian):
+ *   header    magic (8 bytes), u32 version, u32 section count, u64 file size, u64 header checksum, 16 bytes reserved
+ *   sections  u32 id, u32 element bytes, u64 element count, u64 offset, u64 data checksum, u32 window, u32 max bits
+ *   data      fixed width elements of each section
+ *
+ * The header checksum (FNV-1a) covers the header and the section list with the checksum field as zero.
+ */
+class SectionFile
+{
+public:
+  struct Section
+  {
+    uint32_t id;
+    uint32_t elementBytes;
+    uint64_t count;
+    uint64_t offset;
+    uint64_t checksum;
+    uint32_t window;
+    uint32_t maxBits;
+  };
+
+  /**
+   * @brief Section to be written, bytes holds count * elementBytes bytes
+   */
+  struct Content
+  {
+    uint32_t id;
+    uint32_t elementBytes;
+    binary_t bytes;
+    uint32_t window;
+    uint32_t maxBits;
+  };
+
+private:
+  string name;
+  const uint8_t *data = nullptr;
+  size_t length = 0;
+  vector<Section> sections;
+
+public:
+  /**
+   * @brief Map a section file, the magic, version, header checksum and the section bounds are validated
+   *
+   * @param path File path
+   * @param magic File magic, 8 bytes
+   * @param version Expected version
+   * @param name File kind used in error messages, eg. "parameter bundle"
+   */
+  SectionFile(const string &path, const string &magic, uint32_t version, const string &name);
+
+  ~SectionFile();
+
+  SectionFile(const SectionFile &) = delete;
+  SectionFile &operator=(const SectionFile &) = delete;
+
+  /**
+   * @brief Write the sections to a file
+   *
+   * @param path File path
+   * @param magic File magic, 8 bytes
+   * @param version File version
+   * @param contents Sections in order
+   * @param name File kind used in error messages
+   */
+  static void write(const string &path, const string &magic, uint32_t version, const vector<Content> &contents, const string &name);
+
+  /**
+   * @brief Encode big integers to a section, the element width is the size of the largest value
+   *
+   * @param id Section id
+   * @param values Non-negative values
+   * @param window Section window field
+   * @param maxBits Section max bits field
+   * @return Content
+   */
+  static Content encode(uint32_t id, const Vec<ZZ> &values, uint32_t window = 0, uint32_t maxBits = 0);
+
+  static uint64_t checksum(const uint8_t *data, size_t length);
+
+  static void putU32(uint8_t *p, uint32_t v);
+  static void putU64(uint8_t *p, uint64_t v);
+  static uint32_t getU32(const uint8_t *p);
+  static uint64_t getU64(const uint8_t *p);
+
+  /**
+   * @brief Get a section by id, the index counts the sections of the same id
+   *
+   * @param id Section id
+   * @param index Index among the sections of the id
+   * @return const Section&
+   */
+  const Section &section(uint32_t id, size_t index = 0) const;
+
+  /**
+   * @brief Number of sections of an id
+   *
+   * @param id Section id
+   * @return size_t
+   */
+  size_t sectionCount(uint32_t id) const;
+
+  /**
+   * @brief Pointer to the mapped bytes of element i of a section
+   *
+   * @param s Section
+   * @param i Element index
+   * @return const uint8_t*
+   */
+  const uint8_t *at(const Section &s, size_t i) const;
+
+  /**
+   * @brief Decode element i of a section as a big integer
+   *
+   * @param s Section
+   * @param i Element index
+   * @return ZZ
+   */
+  ZZ element(const Section &s, size_t i) const;
+
+  /**
+   * @brief Check the data checksum of every section, it reads the whole file
+   *
+   * @return true
+   * @return false
+   */
+  bool verifyData() const;
+};
+
+} // namespace polyu
@@ -1,7 +1,8 @@
 #include "./Timer.hpp"
 
-map<string, high_resolution_clock::time_point> Timer::t1;
-map<string, high_resolution_clock::time_point> Timer::t2;
+thread_local map<string, high_resolution_clock::time_point> Timer::t1;
+thread_local map<string, high_resolution_clock::time_point> Timer::t2;
+thread_local bool Timer::silent = false;
 
 void Timer::start(const string &name)
 {
@@ -13,7 +14,7 @@ double Timer::end(const string &name, bool quite)
   Timer::t2[name] = high_resolution_clock::now();
   double tDiff = duration_cast<milliseconds>(Timer::t2[name] - Timer::t1[name]).count();
   tDiff /= 1000;
-  if (!quite)
+  if (!quite && !silent)
   {
     cout << name << " time: " << tDiff << endl;
   }
@@ -25,7 +26,7 @@ double Timer::endNan(const string &name, bool quite)
 {
   Timer::t2[name] = high_resolution_clock::now();
   double tDiff = duration_cast<nanoseconds>(Timer::t2[name] - Timer::t1[name]).count();
-  if (!quite)
+  if (!quite && !silent)
   {
     cout << name << " time: " << tDiff << endl;
   }
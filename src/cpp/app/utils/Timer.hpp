@@ -12,8 +12,12 @@ namespace polyu
 class Timer
 {
 public:
-  static map<string, high_resolution_clock::time_point> t1;
-  static map<string, high_resolution_clock::time_point> t2;
+  // timers are per thread, so concurrent jobs can use the same names
+  static thread_local map<string, high_resolution_clock::time_point> t1;
+  static thread_local map<string, high_resolution_clock::time_point> t2;
+
+  /// @brief Do not print the timers of the calling thread, eg. in service workers
+  static thread_local bool silent;
 
   static void start(const string &name);
   static double end(const string &name, bool quite = false);
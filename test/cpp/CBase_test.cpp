@@ -322,4 +322,32 @@ TEST(CBase, Append)
   EXPECT_EQ(circuit1->B->toString(), "[[\"0\",\"0\",\"3\",\"4\",\"0\",\"0\",\"4\",\"5\",\"6\"]]");
   EXPECT_EQ(circuit1->C->toString(), "[[\"0\",\"0\",\"0\",\"0\",\"5\",\"6\",\"7\",\"8\",\"9\"]]");
 }
+
+TEST(CBase, Layout)
+{
+  auto GP_P = conv<ZZ>("101");
+  ZZ_pPush push(GP_P);
+
+  auto circuit = make_shared<CBase>(conv<ZZ>("607"), GP_P, ZZ_p());
+  circuit->addGate(2);
+  circuit->addGate(2, true);
+  circuit->addGate(1);
+  EXPECT_EQ(circuit->gateCount, 5);
+
+  // small gates first, the others keep their order
+  auto position = circuit->layout();
+  EXPECT_EQ(position, vector<size_t>({2, 3, 0, 1, 4}));
+
+  circuit->A->cell(0, 0, 5);
+  circuit->A->cell(0, 2, 1);
+  EXPECT_EQ(circuit->A->permute(position)->toString(), "[[\"1\",\"0\",\"5\",\"0\",\"0\"]]");
+
+  // hints follow the appended circuit
+  auto circuit2 = make_shared<CBase>(conv<ZZ>("607"), GP_P, ZZ_p());
+  circuit2->addGate(1, true);
+  circuit2->addLinear();
+  circuit->addLinear();
+  circuit->append(circuit2);
+  EXPECT_EQ(circuit->layout(), vector<size_t>({3, 4, 0, 1, 5, 2}));
+}
 } // namespace
@@ -151,6 +151,84 @@ TEST(CEnc, Run_circuit)
   EXPECT_TRUE(isValid);
 }
 
+TEST(CEnc, Verify_batch)
+{
+  ZZ_p::init(GP_P);
+
+  vector<shared_ptr<CircuitZKPVerifier>> verifiers;
+  vector<Vec<ZZ_p>> proofs;
+  Vec<ZZ_p> ys, xs;
+  for (long k = 0; k < 5; k++)
+  {
+    auto msg = conv<ZZ>(100 + k);
+    auto rand = conv<ZZ_p>(456 + k);
+    auto c = encryptor->encrypt(msg, rand);
+
+    auto circuit = make_shared<CEnc>(crypto);
+    circuit->wireUp(c);
+    circuit->run(msg, rand);
+    auto mnCfg = CircuitZKPVerifier::calcMN(circuit->gateCount);
+    circuit->group(mnCfg[1], mnCfg[0]);
+    circuit->trim();
+
+    auto verifier = make_shared<CircuitZKPVerifier>(
+        GP_Q, GP_P, GP_G,
+        circuit->Wqa, circuit->Wqb, circuit->Wqc, circuit->Kq,
+        mnCfg[0], mnCfg[1], circuit->linearCount);
+    auto prover = make_shared<CircuitZKPProver>(verifier, circuit->A, circuit->B, circuit->C);
+
+    Vec<ZZ_p> commits, pc, proof;
+    prover->commit(commits);
+    verifier->setCommits(commits);
+    auto y = verifier->calculateY();
+    prover->polyCommit(y, pc);
+    verifier->setPolyCommits(pc);
+    auto x = verifier->calculateX();
+    prover->prove(y, x, proof);
+
+    verifiers.push_back(verifier);
+    proofs.push_back(proof);
+    ys.append(y);
+    xs.append(x);
+  }
+
+  Timer::start("verifyBatch");
+  EXPECT_EQ(CircuitZKPVerifier::verifyBatch(verifiers, proofs, ys, xs), vector<bool>(5, true));
+  auto batchTime = Timer::end("verifyBatch");
+
+  Timer::start("verifyEach");
+  for (size_t k = 0; k < verifiers.size(); k++)
+    EXPECT_TRUE(verifiers[k]->verify(proofs[k], ys[k], xs[k]));
+  auto eachTime = Timer::end("verifyEach");
+
+  cout << "verify batch: " << batchTime << "s" << endl;
+  cout << "verify each: " << eachTime << "s" << endl;
+
+  // a bad rr only breaks the group equation, a bad pe breaks the scalar check
+  {
+    ZZ_pPush push(GP_P);
+    proofs[1][proofs[1].length() - 1] += 1;
+    proofs[3][0] += 1;
+  }
+  auto ret = CircuitZKPVerifier::verifyBatch(verifiers, proofs, ys, xs);
+  EXPECT_EQ(ret, vector<bool>({true, false, true, false, true}));
+  for (size_t k = 0; k < verifiers.size(); k++)
+    EXPECT_EQ(verifiers[k]->verify(proofs[k], ys[k], xs[k]), ret[k]);
+
+  // order 2 errors in two proofs are cleared by the cofactor instead of cancelling
+  // out under the weights, an order p error next to one is still caught
+  {
+    ZZ_pPush push(GP_Q);
+    verifiers[0]->commitA[0] = -verifiers[0]->commitA[0];
+    verifiers[2]->commitD = -verifiers[2]->commitD;
+    verifiers[4]->commitD = -verifiers[4]->commitD * GP_G;
+  }
+  ret = CircuitZKPVerifier::verifyBatch(verifiers, proofs, ys, xs);
+  EXPECT_EQ(ret, vector<bool>({true, false, true, false, false}));
+  for (size_t k = 0; k < verifiers.size(); k++)
+    EXPECT_EQ(verifiers[k]->verify(proofs[k], ys[k], xs[k]), ret[k]);
+}
+
 /*
 TEST(CEnc, Speed_test)
 {
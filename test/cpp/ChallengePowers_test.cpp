@@ -0,0 +1,53 @@
+#include "gtest/gtest.h"
+
+#include "app/namespace.hpp"
+
+#include "app/ChallengePowers.hpp"
+
+namespace
+{
+
+TEST(ChallengePowers, Powers)
+{
+  auto p = conv<ZZ>(101);
+  ZZ_pPush push(p);
+  size_t m = 3, n = 4, Q = 5;
+  size_t M = m * n + m;
+  auto y = conv<ZZ_p>(7);
+  auto x = conv<ZZ_p>(12);
+
+  ChallengePowers cp(p, m, n, Q, y, x);
+  EXPECT_TRUE(cp.hasX());
+  EXPECT_EQ(cp.getY(), y);
+  EXPECT_EQ(cp.getX(), x);
+
+  for (long i = 0; i <= (long)m; i++)
+  {
+    EXPECT_EQ(cp.getYi()[i], power(y, i));
+    EXPECT_EQ(cp.getInvYi()[i], power(y, -i));
+  }
+  for (long j = 0; j < (long)n; j++)
+    EXPECT_EQ(cp.getY_()[j], power(y, (j + 1) * m));
+  for (long q = 1; q <= (long)Q; q++)
+    EXPECT_EQ(cp.getYMq()[q - 1], power(y, M + q));
+  for (long i = 0; i <= 2 * (long)m + 1; i++)
+    EXPECT_EQ(cp.getXi()[i], power(x, i));
+  for (long i = 0; i <= 2 * (long)m; i++)
+    EXPECT_EQ(cp.getInvXi()[i], power(x, -i));
+}
+
+TEST(ChallengePowers, Without_x)
+{
+  auto p = conv<ZZ>(101);
+  ZZ_pPush push(p);
+
+  ChallengePowers cp(p, 2, 2, 1, conv<ZZ_p>(3));
+  EXPECT_FALSE(cp.hasX());
+  EXPECT_EQ(cp.getInvYi()[2], inv(conv<ZZ_p>(9)));
+  EXPECT_THROW(cp.getX(), invalid_argument);
+  EXPECT_THROW(cp.getXi(), invalid_argument);
+
+  EXPECT_THROW(ChallengePowers(p, 2, 2, 1, conv<ZZ_p>(0)), invalid_argument);
+}
+
+} // namespace
@@ -136,6 +136,70 @@ TEST(CircuitZKP, Test_1)
   isValid = verifier->verify(fakeProofs2, y1, x1);
 
   EXPECT_FALSE(isValid);
+
+  // commit(r, rr) is one equation with negated exponents of g and gi,
+  // a single wrong r[i] or commitment must break it
+  {
+    auto cp = verifier->challengePowers(y1, x1);
+    auto &scheme = verifier->commitScheme;
+    Vec<ZZ_p> r;
+    ConvertUtils::subVec(proofs, r, verifier->txN + 1, verifier->txN + 1 + n);
+    auto rr = proofs[proofs.length() - 1];
+    auto check = [&](const Vec<ZZ_p> &r) {
+      CircuitZKPVerifier::Equation eq;
+      verifier->commitEquation(r, rr, cp, eq);
+      return scheme->isIdentity(scheme->commitExps(eq.exps, 1, eq.bases, eq.baseExps));
+    };
+    EXPECT_TRUE(check(r));
+
+    Vec<ZZ_p> fakeR = r;
+    Vec<ZZ_p> fakeProofs3 = proofs;
+    {
+      ZZ_pPush push(p);
+      fakeR[0] += 1;
+      fakeProofs3[verifier->txN + 1] = fakeR[0];
+    }
+    EXPECT_FALSE(check(fakeR));
+    EXPECT_FALSE(verifier->verify(fakeProofs3, y1, x1));
+
+    auto A0 = verifier->commitA[0];
+    {
+      ZZ_pPush push(Q);
+      verifier->commitA[0] *= g;
+    }
+    EXPECT_FALSE(check(r));
+    EXPECT_FALSE(verifier->verify(proofs, y1, x1));
+    verifier->commitA[0] = A0;
+
+    auto D = verifier->commitD;
+    {
+      ZZ_pPush push(Q);
+      verifier->commitD *= g;
+    }
+    EXPECT_FALSE(check(r));
+    EXPECT_FALSE(verifier->verify(proofs, y1, x1));
+    verifier->commitD = D;
+
+    EXPECT_TRUE(verifier->verify(proofs, y1, x1));
+  }
+
+  // s(x) evaluated from the wire entries equals x^-2m * s(X) at x
+  {
+    ZZ_pPush push(p);
+    vector<ZZ_pX> sx;
+    Vec<ZZ_p> expected, ret;
+    ZZ_p tmp;
+    auto cp = verifier->challengePowers(y1, x1);
+    verifier->createSx(cp, sx);
+    expected.SetLength(n);
+    for (size_t j = 0; j < n; j++)
+    {
+      eval(tmp, sx[j], x1);
+      expected[j] = tmp * power(x1, -2 * (long)m);
+    }
+    verifier->evalSx(cp, ret);
+    EXPECT_EQ(ret, expected);
+  }
 }
 
 TEST(CircuitZKP, Test_2)
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include "app/namespace.hpp"
+
+#include "app/math/CompactMat.hpp"
+#include "app/math/MathUtils.hpp"
+
+namespace
+{
+
+TEST(CompactMat, Classify)
+{
+  auto p = GenPrime_ZZ(256);
+  ZZ_pPush push(p);
+
+  Mat<ZZ_p> mat;
+  mat.SetDims(2, 3);
+  mat[0][0] = 1;
+  mat[0][1] = -1;
+  mat[0][2] = 12345;
+  mat[1][1] = MathUtils::randZZ_p(p);
+
+  CompactMat compact(mat, p);
+  EXPECT_EQ(compact.NumRows(), 2);
+  EXPECT_EQ(compact.NumCols(), 3);
+  EXPECT_EQ(compact.fullCount(), 1);
+
+  Mat<ZZ_p> ret;
+  compact.toMat(ret);
+  EXPECT_EQ(ret, mat);
+  EXPECT_EQ(compact.get(0, 1), conv<ZZ_p>(-1));
+
+  Vec<ZZ> exps;
+  compact.exponents(0, exps);
+  EXPECT_EQ(exps[0], 1);
+  EXPECT_EQ(exps[1], -1);
+  EXPECT_EQ(exps[2], 12345);
+  compact.exponents(1, exps);
+  EXPECT_EQ(exps[0], 0);
+  EXPECT_EQ(exps[1], rep(mat[1][1]));
+
+  EXPECT_THROW(compact.get(2, 0), invalid_argument);
+}
+
+TEST(CompactMat, From_sparse_matrix)
+{
+  auto p = conv<ZZ>("101");
+  ZZ_pPush push(p);
+
+  Matrix sparse(2, 4);
+  sparse.cell(0, 1, 1);
+  sparse.cell(1, 3, -2);
+
+  CompactMat compact(sparse, p);
+  Mat<ZZ_p> expected, ret;
+  sparse.toMat(expected);
+  compact.toMat(ret);
+  EXPECT_EQ(ret, expected);
+  EXPECT_EQ(compact.fullCount(), 0);
+}
+
+} // namespace
@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+
+#include "app/math/FixedBase.hpp"
+
+namespace
+{
+
+TEST(FixedBase, Power)
+{
+  auto modulus = RandomBits_ZZ(256);
+  SetBit(modulus, 0);
+  auto base = RandomBnd(modulus);
+
+  for (long window = 0; window <= 6; window++)
+  {
+    FixedBase fb(base, modulus, 128, window);
+    EXPECT_EQ(fb.power(ZZ(0)), 1);
+    EXPECT_EQ(fb.power(ZZ(1)), base);
+
+    for (int i = 0; i < 10; i++)
+    {
+      auto a = RandomBits_ZZ(128);
+      EXPECT_EQ(fb.power(a), PowerMod(base, a, modulus)) << "window = " << window;
+    }
+
+    // longer than the table
+    auto a = RandomBits_ZZ(200);
+    EXPECT_EQ(fb.power(a), PowerMod(base, a, modulus));
+  }
+
+  EXPECT_THROW(FixedBase(base, modulus, 128).power(ZZ(-1)), invalid_argument);
+}
+
+} // namespace
@@ -0,0 +1,67 @@
+#include "gtest/gtest.h"
+
+#include "app/math/MultiExp.hpp"
+
+namespace
+{
+
+TEST(MultiExp, Power)
+{
+  auto modulus = RandomBits_ZZ(256);
+  SetBit(modulus, 0);
+  ZZ_pPush push(modulus);
+
+  for (long n : {0, 1, 2, 10, 100})
+  {
+    Vec<ZZ_p> bases;
+    Vec<ZZ> exps;
+    ZZ_p expected(1);
+    for (long i = 0; i < n; i++)
+    {
+      ZZ_p b;
+      random(b);
+      auto e = RandomBits_ZZ(i % 3 == 0 ? 0 : 200);
+      bases.append(b);
+      exps.append(e);
+      expected *= power(b, e);
+    }
+
+    EXPECT_EQ(MultiExp::power(bases, exps), expected) << "n = " << n;
+    EXPECT_EQ(MultiExp::power(bases, exps, 3), expected) << "n = " << n;
+  }
+
+  Vec<ZZ_p> bases;
+  bases.SetLength(2);
+  Vec<ZZ> exps;
+  exps.SetLength(1);
+  EXPECT_THROW(MultiExp::power(bases, exps), invalid_argument);
+}
+
+TEST(MultiExp, Power_exponent_lengths)
+{
+  auto modulus = RandomBits_ZZ(128);
+  SetBit(modulus, 0);
+  ZZ_pPush push(modulus);
+
+  // windows of different size and digits across byte boundaries
+  for (long bits : {1, 7, 8, 9, 17, 100, 1000})
+  {
+    for (long n : {1, 3, 50})
+    {
+      Vec<ZZ_p> bases, exps;
+      ZZ_p expected(1);
+      for (long i = 0; i < n; i++)
+      {
+        ZZ_p b;
+        random(b);
+        auto e = RandomLen_ZZ(bits);
+        bases.append(b);
+        exps.append(conv<ZZ_p>(e));
+        expected *= power(b, rep(exps[i]));
+      }
+      EXPECT_EQ(MultiExp::power(bases, exps), expected) << "bits = " << bits << ", n = " << n;
+    }
+  }
+}
+
+} // namespace
@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "app/namespace.hpp"
+
+#include "app/ParamBundle.hpp"
+#include "app/PaillierEncryption.hpp"
+
+namespace
+{
+
+TEST(ParamBundle, Save_and_load)
+{
+  char tmp[] = "/tmp/param_bundle_test_XXXXXX";
+  close(mkstemp(tmp));
+  string path = tmp;
+  auto crypto = make_shared<PaillierEncryption>(16);
+  auto gi = crypto->genGenerators(10);
+  FixedBase table(rep(gi[0]), crypto->getGroupQ(), 64);
+
+  ParamBundle::save(path, crypto, gi, {table});
+
+  {
+    ParamBundle params(path);
+    EXPECT_TRUE(params.verifyData());
+    EXPECT_EQ(params.getPublicKey(), crypto->getPublicKey());
+    EXPECT_EQ(params.getGroupQ(), crypto->getGroupQ());
+    EXPECT_EQ(params.getGroupP(), crypto->getGroupP());
+    EXPECT_EQ(params.getGroupG(), crypto->getGroupG());
+    EXPECT_EQ(params.generatorCount(), 10);
+    EXPECT_EQ(params.getGenerators(), gi);
+    EXPECT_EQ(params.getGenerators(3).length(), 3);
+    EXPECT_THROW(params.getGenerators(11), invalid_argument);
+
+    ASSERT_EQ(params.tableCount(), 1);
+    auto loaded = params.getTable(0);
+    auto a = RandomBits_ZZ(64);
+    EXPECT_EQ(loaded.power(a), table.power(a));
+
+    auto encryptor = params.toEncryption();
+    EXPECT_FALSE(encryptor->isKeyHolder());
+    auto m = conv<ZZ>(123);
+    EXPECT_EQ(crypto->decrypt(encryptor->encrypt(m)), m);
+  }
+
+  // corrupted header
+  {
+    fstream fs(path, ios::in | ios::out | ios::binary);
+    fs.seekp(12);
+    fs.put(7);
+  }
+  EXPECT_THROW(ParamBundle params(path), invalid_argument);
+  EXPECT_THROW(ParamBundle params("not_exists.bin"), invalid_argument);
+
+  remove(path.c_str());
+}
+
+} // namespace
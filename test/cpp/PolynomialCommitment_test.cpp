@@ -2,6 +2,7 @@
 
 #include "app/PolynomialCommitment.hpp"
 #include "app/PaillierEncryption.hpp"
+#include "app/ParamBundle.hpp"
 #include "app/math/MathUtils.hpp"
 #include "app/utils/ConvertUtils.hpp"
 
@@ -29,6 +30,184 @@ TEST(PolynomialCommitment, commit)
   EXPECT_EQ(ConvertUtils::toString(c), "100");
 }
 
+TEST(PolynomialCommitment, commit_parallel)
+{
+  auto crypto = make_shared<PaillierEncryption>(16);
+  PolynomialCommitment commitScheme(crypto, 20);
+  auto p = crypto->getGroupP();
+
+  Mat<ZZ_p> ms;
+  Vec<ZZ_p> rs;
+  {
+    ZZ_pPush push(p);
+    ms.SetDims(6, 20);
+    for (long i = 0; i < ms.NumRows(); i++)
+      MathUtils::randVecZZ_p(20, p, ms[i]);
+    MathUtils::randVecZZ_p(6, p, rs);
+  }
+
+  Vec<ZZ_p> expected;
+  expected.SetLength(ms.NumRows());
+  for (long i = 0; i < ms.NumRows(); i++)
+    expected[i] = commitScheme.commit(ms[i], rs[i], 1);
+
+  // same result regardless of the thread budget
+  for (size_t threads : {1, 2, 4, 16})
+  {
+    commitScheme.threads = threads;
+    Vec<ZZ_p> ret;
+    commitScheme.commit(ms, rs, ret);
+    EXPECT_EQ(ret, expected) << "threads = " << threads;
+    EXPECT_EQ(commitScheme.commit(ms[0], rs[0]), expected[0]);
+  }
+}
+
+TEST(PolynomialCommitment, commit_fixed_base)
+{
+  auto crypto = make_shared<PaillierEncryption>(16);
+  PolynomialCommitment commitScheme(crypto, 20);
+  auto p = crypto->getGroupP();
+
+  Vec<ZZ_p> mi;
+  ZZ_p r;
+  {
+    ZZ_pPush push(p);
+    MathUtils::randVecZZ_p(20, p, mi);
+    r = MathUtils::randZZ_p(p);
+  }
+  auto expected = commitScheme.commit(mi, r);
+
+  // tables for g and the first 7 generators
+  EXPECT_EQ(commitScheme.precompute(commitScheme.tableBytes(8)), 8);
+  EXPECT_EQ(commitScheme.getTables().size(), 8);
+  EXPECT_EQ(commitScheme.precompute(commitScheme.tableBytes(8) - 1), 7);
+  EXPECT_EQ(commitScheme.precompute(commitScheme.tableBytes(1) - 1), 0);
+  EXPECT_EQ(commitScheme.precompute(commitScheme.tableBytes(8)), 8);
+
+  // the generator tables only cover short exponents
+  EXPECT_EQ(commitScheme.getTables()[0].maxBits, NumBits(p));
+  EXPECT_EQ(commitScheme.getTables()[1].maxBits, CompactMat::SMALL_BITS);
+  EXPECT_LT(commitScheme.tableBytes(2) - commitScheme.tableBytes(1), commitScheme.tableBytes(1));
+  EXPECT_EQ(commitScheme.commit(mi, r), expected);
+  EXPECT_EQ(commitScheme.commit(mi, r, 4), expected);
+
+  // the budget is capped by the number of bases
+  EXPECT_EQ(commitScheme.precompute(commitScheme.tableBytes(100)), 21);
+  EXPECT_EQ(commitScheme.commit(mi, r), expected);
+
+  // load from a parameter bundle
+  string path = "poly_commit_tables_test.bin";
+  ParamBundle::save(path, crypto, commitScheme.gi, commitScheme.getTables());
+  {
+    ParamBundle params(path);
+    vector<FixedBase> tables;
+    for (size_t i = 0; i < params.tableCount(); i++)
+      tables.push_back(params.getTable(i));
+
+    PolynomialCommitment loaded(crypto, params.getGenerators());
+    EXPECT_EQ(loaded.setTables(tables), 21);
+    EXPECT_EQ(loaded.commit(mi, r), expected);
+
+    // tables stop at the first mismatching base
+    tables.erase(tables.begin() + 3);
+    EXPECT_EQ(loaded.setTables(tables), 3);
+    EXPECT_EQ(loaded.commit(mi, r), expected);
+  }
+  remove(path.c_str());
+}
+
+TEST(PolynomialCommitment, commit_compact)
+{
+  auto crypto = make_shared<PaillierEncryption>(16);
+  PolynomialCommitment commitScheme(crypto, 20);
+  auto p = crypto->getGroupP();
+
+  // rows of 0, 1, -1, small and full width values
+  Mat<ZZ_p> ms;
+  Vec<ZZ_p> rs;
+  {
+    ZZ_pPush push(p);
+    ms.SetDims(4, 20);
+    for (long j = 0; j < 20; j++)
+    {
+      ms[0][j] = j % 2;
+      ms[1][j] = -(j % 3);
+      ms[2][j] = j * 1000 - 7;
+      ms[3][j] = MathUtils::randZZ_p(p);
+    }
+    ms[0][3] = MathUtils::randZZ_p(p);
+    MathUtils::randVecZZ_p(4, p, rs);
+  }
+
+  // reference: one PowerMod per base
+  Vec<ZZ_p> expected;
+  expected.SetLength(ms.NumRows());
+  {
+    ZZ_pPush push(commitScheme.Q);
+    for (long i = 0; i < ms.NumRows(); i++)
+    {
+      expected[i] = power(commitScheme.g, rep(rs[i]));
+      for (long j = 0; j < ms.NumCols(); j++)
+        expected[i] *= power(commitScheme.gi[j], rep(ms[i][j]));
+    }
+  }
+
+  Vec<ZZ_p> ret;
+  commitScheme.commit(ms, rs, ret);
+  EXPECT_EQ(ret, expected);
+  commitScheme.commit(CompactMat(ms, p), rs, ret);
+  EXPECT_EQ(ret, expected);
+
+  commitScheme.precompute(commitScheme.tableBytes(6));
+  commitScheme.commit(CompactMat(ms, p), rs, ret);
+  EXPECT_EQ(ret, expected);
+}
+
+TEST(PolynomialCommitment, commit_blinded)
+{
+  auto crypto = make_shared<PaillierEncryption>(16);
+  PolynomialCommitment commitScheme(crypto, 10);
+  auto p = crypto->getGroupP();
+
+  Mat<ZZ_p> ms;
+  {
+    ZZ_pPush push(p);
+    ms.SetDims(3, 10);
+    for (long i = 0; i < ms.NumRows(); i++)
+      MathUtils::randVecZZ_p(10, p, ms[i]);
+  }
+
+  // background pool, g^r is computed offline
+  commitScheme.attachPool(5, 1);
+  commitScheme.pool->warmUp();
+
+  Vec<ZZ_p> rs, grs, ret, expected;
+  commitScheme.pickBlinding(ms.NumRows(), rs, grs);
+  EXPECT_EQ(commitScheme.pool->getHits(), 3);
+  {
+    ZZ_pPush push(commitScheme.Q);
+    for (long i = 0; i < rs.length(); i++)
+      EXPECT_EQ(grs[i], power(commitScheme.g, rep(rs[i])));
+  }
+
+  commitScheme.commit(ms, rs, expected);
+  commitScheme.commitBlinded(ms, grs, ret);
+  EXPECT_EQ(ret, expected);
+  commitScheme.commitBlinded(CompactMat(ms, p), grs, ret);
+  EXPECT_EQ(ret, expected);
+  EXPECT_EQ(commitScheme.commitBlinded(ms[0], grs[0]), expected[0]);
+
+  // tables are rebuilt while the pool is running
+  commitScheme.precompute(commitScheme.tableBytes(2));
+  ZZ_p r, gr;
+  commitScheme.pickBlinding(r, gr);
+  EXPECT_EQ(commitScheme.commitBlinded(ms[1], gr), commitScheme.commit(ms[1], r));
+
+  commitScheme.detachPool();
+  commitScheme.pickBlinding(r, gr);
+  EXPECT_EQ(commitScheme.commitBlinded(ms[2], gr), commitScheme.commit(ms[2], r));
+}
+
 TEST(PolynomialCommitment, PolyCommit_eval_verify)
 {
   auto Q = conv<ZZ>("607");
@@ -74,6 +253,49 @@ TEST(PolynomialCommitment, PolyCommit_eval_verify)
   EXPECT_EQ(v, conv<ZZ_p>("98"));
 }
 
+TEST(PolynomialCommitment, PolyCommit_eval_blocked)
+{
+  auto crypto = make_shared<PaillierEncryption>(16);
+  auto p = crypto->getGroupP();
+  size_t m1 = 3;
+  size_t m2 = 4;
+  size_t n = 70; // more than one column block
+  PolynomialCommitment commitScheme(crypto, n);
+
+  ZZ_pPush push(p);
+  ZZ_pX poly;
+  random(poly, (m1 + m2) * n);
+  SetCoeff(poly, m1 * n, 0);
+  Vec<ZZ_p> ri;
+  MathUtils::randVecZZ_p(m1 + m2 + 1, p, ri);
+  auto x = MathUtils::randZZ_p(p, true);
+
+  Mat<ZZ_p> T;
+  commitScheme.calcT(m1, m2, n, poly, T);
+
+  // reference: Z = [x^-(m1 n), ..., x^-n, x, x^(n+1), ..., x^2] and [Z * T, Z * r]
+  Vec<ZZ_p> Z, expected;
+  Z.SetLength(m1 + m2 + 1);
+  for (size_t i = 0; i < m1; i++)
+    Z[i] = inv(power(x, (m1 - i) * n));
+  for (size_t i = 0; i < m2; i++)
+    Z[m1 + i] = power(x, i * n + 1);
+  Z[m1 + m2] = x * x;
+  expected.SetLength(n + 1);
+  for (size_t j = 0; j < n; j++)
+    for (size_t i = 0; i < m1 + m2 + 1; i++)
+      expected[j] += Z[i] * T[i][j];
+  for (size_t i = 0; i < m1 + m2 + 1; i++)
+    expected[n] += Z[i] * ri[i];
+
+  Vec<ZZ_p> pe, pc;
+  commitScheme.eval(m1, m2, n, T, ri, x, pe);
+  EXPECT_EQ(pe, expected);
+
+  commitScheme.commit(m1, m2, n, T, ri, pc);
+  EXPECT_TRUE(commitScheme.verify(m1, m2, n, pc, pe, x));
+}
+
 TEST(PolynomialCommitment, PolyCommit_eval_verify2)
 {
   int byteLength = 32;
@@ -124,6 +346,42 @@ TEST(PolynomialCommitment, PolyCommit_eval_verify2)
   EXPECT_TRUE(conv<ZZ>(v) > 0);
 }
 
+TEST(PolynomialCommitment, PolyCommit_verify_reject)
+{
+  auto crypto = make_shared<PaillierEncryption>(16);
+  auto p = crypto->getGroupP();
+  size_t n = 6, m1 = 2, m2 = 3;
+  PolynomialCommitment commitScheme(crypto, n);
+
+  ZZ_p::init(p);
+  ZZ_pX poly;
+  random(poly, (m1 + m2) * n);
+
+  Mat<ZZ_p> T;
+  Vec<ZZ_p> ri, pc, pe;
+  commitScheme.calcT(m1, m2, n, poly, T);
+  commitScheme.commit(m1, m2, n, T, ri, pc);
+  auto x = MathUtils::randZZ_p(p, true);
+  commitScheme.eval(m1, m2, n, T, ri, x, pe);
+  EXPECT_TRUE(commitScheme.verify(m1, m2, n, pc, pe, x));
+
+  // tampered evaluation
+  auto pe2 = pe;
+  pe2[0] += 1;
+  EXPECT_FALSE(commitScheme.verify(m1, m2, n, pc, pe2, x));
+
+  // tampered commitment
+  auto pc2 = pc;
+  {
+    ZZ_pPush push(crypto->getGroupQ());
+    pc2[m1] *= commitScheme.g;
+  }
+  EXPECT_FALSE(commitScheme.verify(m1, m2, n, pc2, pe, x));
+
+  // wrong challenge
+  EXPECT_FALSE(commitScheme.verify(m1, m2, n, pc, pe, x + 1));
+}
+
 TEST(PolynomialCommitment, PolyCommit_eval_verify3)
 {
   // Predefined group element
@@ -0,0 +1,233 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "app/namespace.hpp"
+
+#include "app/Proof.hpp"
+#include "app/VerifierKey.hpp"
+#include "app/VerificationService.hpp"
+#include "app/CBatchEnc.hpp"
+#include "app/CircuitZKPProver.hpp"
+#include "app/PaillierEncryption.hpp"
+#include "app/utils/ConvertUtils.hpp"
+#include "app/utils/SectionFile.hpp"
+
+namespace
+{
+
+int connectTo(const string &path)
+{
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  memcpy(addr.sun_path, path.c_str(), path.size());
+
+  // the socket is bound by the serving thread
+  for (int i = 0; i < 500; i++)
+  {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0)
+      return fd;
+    close(fd);
+    this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  return -1;
+}
+
+// send a frame, returns the reply or -1 if the client is closed
+int request(int fd, const binary_t &data)
+{
+  uint8_t header[4];
+  SectionFile::putU32(header, data.size());
+  send(fd, header, sizeof(header), MSG_NOSIGNAL);
+  send(fd, data.data(), data.size(), MSG_NOSIGNAL);
+
+  uint8_t reply;
+  return recv(fd, &reply, 1, 0) == 1 ? reply : -1;
+}
+
+TEST(VerificationService, Stateless_verify)
+{
+  int byteLength = 8;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto GP_Q = crypto->getGroupQ();
+  auto GP_P = crypto->getGroupP();
+  auto GP_G = crypto->getGroupG();
+  auto encryptor = make_shared<PaillierEncryption>(crypto->getPublicKey(), GP_Q, GP_P, GP_G);
+  ZZ_p::init(GP_P);
+
+  size_t msgCount = 4;
+  size_t rangeProofCount = 3;
+  size_t slotSize = 2;
+  size_t msgPerBatch = 3;
+  auto key = make_shared<VerifierKey>(encryptor, msgCount, rangeProofCount, slotSize, msgPerBatch);
+
+  // P: prove a batch
+  auto proverCir = make_shared<CBatchEnc>(crypto, msgCount, rangeProofCount, slotSize, msgPerBatch);
+  Vec<ZZ> msg;
+  msg.append(ConvertUtils::hexToZZ("0001000100010001"));
+  msg.append(ConvertUtils::hexToZZ("0000000100010001"));
+  msg.append(ConvertUtils::hexToZZ("0000000000010001"));
+  msg.append(ConvertUtils::hexToZZ("0001000000000000"));
+  proverCir->encrypt(msg);
+  auto ljir = proverCir->calculateLjir();
+  auto Lj = proverCir->calculateLj(ljir);
+  proverCir->wireUp(ljir, Lj);
+  proverCir->run(ljir, Lj);
+
+  auto gi = crypto->genGenerators(proverCir->estimateGeneratorsRequired());
+  auto prover = proverCir->generateProver(gi);
+
+  Proof proof;
+  proof.Cm = proverCir->Cm;
+  proof.Cm_ = proverCir->Cm_;
+  proof.CRj = proverCir->CRj;
+  proof.Lj = Lj;
+  prover->commit(proof.commits);
+  auto y = CircuitZKPVerifier::calculateY(GP_P, proof.commits);
+  prover->polyCommit(y, proof.pc);
+  auto x = CircuitZKPVerifier::calculateX(GP_P, proof.pc);
+  prover->prove(y, x, proof.proofs);
+
+  // same challenges as the stateful verifier
+  prover->zkp->setCommits(proof.commits);
+  prover->zkp->setPolyCommits(proof.pc);
+  EXPECT_EQ(prover->zkp->calculateY(), y);
+  EXPECT_EQ(prover->zkp->calculateX(), x);
+
+  // the challenges do not disturb the random stream of the caller
+  SetSeed(conv<ZZ>(1));
+  auto r1 = RandomBits_ZZ(64);
+  SetSeed(conv<ZZ>(1));
+  CircuitZKPVerifier::calculateY(GP_P, proof.commits);
+  EXPECT_EQ(RandomBits_ZZ(64), r1);
+
+  auto scheme = make_shared<PolynomialCommitment>(GP_Q, GP_P, GP_G, gi);
+  scheme->threads = 1;
+  auto data = proof.toBinary();
+  auto parsed = Proof::fromBinary(data, GP_Q, GP_P);
+  EXPECT_EQ(parsed.toBinary(), data);
+
+  VerifierKey::Latency latency;
+  EXPECT_TRUE(key->verify(parsed, scheme, &latency));
+  EXPECT_GT(latency.verify, 0);
+
+  auto bad = parsed;
+  bad.proofs[0] += 1;
+  EXPECT_FALSE(key->verify(bad, scheme));
+  bad = parsed;
+  bad.commits.SetLength(bad.commits.length() - 1);
+  EXPECT_FALSE(key->verify(bad, scheme));
+
+  auto truncated = data;
+  truncated.pop_back();
+  EXPECT_THROW(Proof::fromBinary(truncated, GP_Q, GP_P), invalid_argument);
+
+  // many proofs at once on the worker pool
+  {
+    VerificationService service(key, scheme, 4);
+    vector<future<bool>> results;
+    for (size_t i = 0; i < 8; i++)
+      results.push_back(service.submit(data));
+    results.push_back(service.submit(truncated));
+    for (size_t i = 0; i < 8; i++)
+      EXPECT_TRUE(results[i].get());
+    EXPECT_FALSE(results[8].get());
+
+    auto stats = service.getStats();
+    EXPECT_EQ(stats.proofs, 9);
+    EXPECT_EQ(stats.valid, 8);
+    EXPECT_EQ(stats.malformed, 1);
+    EXPECT_GT(stats.proofsPerSecond(), 0);
+  }
+
+  char tmp[] = "/tmp/verification_service_test_XXXXXX";
+  string dir = mkdtemp(tmp);
+
+  // proof files of a directory
+  proof.save(dir + "/a.proof");
+  bad.save(dir + "/b.proof");
+  {
+    VerificationService service(key, scheme, 2);
+    stringstream out;
+    EXPECT_EQ(service.verifyDirectory(dir, out), 1);
+    EXPECT_EQ(out.str(), "a.proof valid\nb.proof invalid\n");
+  }
+
+  // length-prefixed frames on a unix socket
+  {
+    VerificationService service(key, scheme, 2);
+    string path = dir + "/service.sock";
+    thread server([&]() { service.serve(path); });
+
+    int fd = connectTo(path);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(request(fd, data), 1);
+    EXPECT_EQ(request(fd, bad.toBinary()), 0);
+    EXPECT_EQ(request(fd, truncated), 0);
+
+    // a frame larger than any proof of the key closes the client
+    EXPECT_EQ(request(fd, binary_t(key->proofBytes() + 1)), -1);
+    close(fd);
+
+    // stop wakes up the idle clients
+    int idle = connectTo(path);
+    int active = connectTo(path);
+    EXPECT_EQ(request(active, data), 1);
+    service.stop();
+    server.join();
+    EXPECT_EQ(request(idle, data), -1);
+    close(idle);
+    close(active);
+
+    auto stats = service.getStats();
+    EXPECT_EQ(stats.proofs, 4);
+    EXPECT_EQ(stats.valid, 2);
+    EXPECT_EQ(stats.malformed, 1);
+  }
+
+  // a stop before serving is not lost
+  {
+    VerificationService service(key, scheme, 1);
+    service.stop();
+    service.serve(dir + "/stopped.sock");
+    stringstream out;
+    service.watchDirectory(dir, out);
+    EXPECT_EQ(out.str(), "");
+    EXPECT_EQ(service.getStats().proofs, 0);
+  }
+
+  // stop a watching service, each file is verified once
+  {
+    VerificationService service(key, scheme, 1);
+    stringstream out;
+    thread watcher([&]() { service.watchDirectory(dir, out, 10); });
+    for (int i = 0; i < 500 && service.getStats().proofs < 2; i++)
+      this_thread::sleep_for(chrono::milliseconds(10));
+    this_thread::sleep_for(chrono::milliseconds(50));
+    service.stop();
+    watcher.join();
+    EXPECT_EQ(out.str(), "a.proof valid\nb.proof invalid\n");
+    EXPECT_EQ(service.getStats().proofs, 2);
+  }
+
+  // the scheme must be over the group of the key
+  {
+    auto other = make_shared<PaillierEncryption>(byteLength);
+    auto otherScheme = make_shared<PolynomialCommitment>(other->getGroupQ(), other->getGroupP(), other->getGroupG(), gi);
+    EXPECT_THROW(VerificationService service(key, otherScheme), invalid_argument);
+  }
+
+  remove((dir + "/a.proof").c_str());
+  remove((dir + "/b.proof").c_str());
+  rmdir(dir.c_str());
+}
+
+} // namespace
@@ -0,0 +1,136 @@
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <cstdlib>
+#include <unistd.h>
+
+#include "app/namespace.hpp"
+
+#include "app/VerifierKey.hpp"
+#include "app/CBatchEnc.hpp"
+#include "app/CircuitZKPVerifier.hpp"
+#include "app/CircuitZKPProver.hpp"
+#include "app/PaillierEncryption.hpp"
+#include "app/utils/ConvertUtils.hpp"
+
+namespace
+{
+
+TEST(VerifierKey, Patch_and_verify)
+{
+  char tmp[] = "/tmp/verifier_key_test_XXXXXX";
+  close(mkstemp(tmp));
+  string path = tmp;
+  int byteLength = 8;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto GP_Q = crypto->getGroupQ();
+  auto GP_P = crypto->getGroupP();
+  auto GP_G = crypto->getGroupG();
+  auto encryptor = make_shared<PaillierEncryption>(crypto->getPublicKey(), GP_Q, GP_P, GP_G);
+  ZZ_p::init(GP_P);
+
+  size_t msgCount = 4;
+  size_t rangeProofCount = 3;
+  size_t slotSize = 2;
+  size_t msgPerBatch = 3;
+
+  // preprocessed once, public key only
+  auto key = make_shared<VerifierKey>(encryptor, msgCount, rangeProofCount, slotSize, msgPerBatch);
+  EXPECT_TRUE(key->matches(crypto->getPublicKey(), GP_Q, GP_P, GP_G, msgCount, rangeProofCount, slotSize, msgPerBatch));
+  EXPECT_FALSE(key->matches(crypto->getPublicKey(), msgCount + 1, rangeProofCount, slotSize, msgPerBatch));
+
+  // P: prove a batch
+  auto proverCir = make_shared<CBatchEnc>(crypto, msgCount, rangeProofCount, slotSize, msgPerBatch);
+  Vec<ZZ> msg;
+  msg.append(ConvertUtils::hexToZZ("0001000100010001"));
+  msg.append(ConvertUtils::hexToZZ("0000000100010001"));
+  msg.append(ConvertUtils::hexToZZ("0000000000010001"));
+  msg.append(ConvertUtils::hexToZZ("0001000000000000"));
+  proverCir->encrypt(msg);
+  auto ljir = proverCir->calculateLjir();
+  auto Lj = proverCir->calculateLj(ljir);
+  proverCir->wireUp(ljir, Lj);
+  proverCir->run(ljir, Lj);
+
+  auto gi = crypto->genGenerators(proverCir->estimateGeneratorsRequired());
+  auto prover = proverCir->generateProver(gi);
+  EXPECT_EQ(key->getM(), prover->zkp->m);
+  EXPECT_EQ(key->getN(), prover->zkp->n);
+  EXPECT_EQ(key->getQ(), prover->zkp->Q);
+
+  Vec<ZZ_p> commits, pc, proofs;
+  prover->commit(commits);
+  prover->zkp->setCommits(commits);
+  auto y = prover->zkp->calculateY();
+  prover->polyCommit(y, pc);
+  prover->zkp->setPolyCommits(pc);
+  auto x = prover->zkp->calculateX();
+  prover->prove(y, x, proofs);
+
+  // V: patch the proof's ciphertexts and challenges into the key
+  auto scheme = make_shared<PolynomialCommitment>(GP_Q, GP_P, GP_G, gi);
+  auto check = [&](const VerifierKey &k) {
+    auto verifier = k.generateVerifier(proverCir->Cm, proverCir->Cm_, proverCir->CRj, ljir, Lj, scheme);
+    verifier->setCommits(commits);
+    verifier->setPolyCommits(pc);
+    return verifier->verify(proofs, verifier->calculateY(), verifier->calculateX());
+  };
+  EXPECT_TRUE(check(*key));
+
+  // same constrains as the fully wired circuit
+  {
+    ZZ_pPush push(GP_P);
+    auto full = prover->zkp;
+    auto patched = key->generateVerifier(proverCir->Cm, proverCir->Cm_, proverCir->CRj, ljir, Lj, scheme);
+    auto cp = full->challengePowers(conv<ZZ_p>(7));
+    EXPECT_EQ(patched->K(cp), full->K(cp));
+    Vec<ZZ_p> w1, w2;
+    for (size_t i = 1; i <= full->m; i++)
+    {
+      patched->Wai(i, cp, w1);
+      full->Wai(i, cp, w2);
+      EXPECT_EQ(w1, w2);
+    }
+  }
+
+  // a proof does not verify against other ciphertexts
+  {
+    auto Cm = proverCir->Cm;
+    Cm[0] = proverCir->Cm[1];
+    auto verifier = key->generateVerifier(Cm, proverCir->Cm_, proverCir->CRj, ljir, Lj, scheme);
+    verifier->setCommits(commits);
+    verifier->setPolyCommits(pc);
+    EXPECT_FALSE(verifier->verify(proofs, verifier->calculateY(), verifier->calculateX()));
+  }
+  EXPECT_THROW(key->generateVerifier(proverCir->Cm_, proverCir->Cm_, proverCir->CRj, ljir, Lj, scheme), invalid_argument);
+
+  // a key of another group is rejected
+  {
+    auto other = make_shared<PaillierEncryption>(byteLength);
+    EXPECT_FALSE(key->matches(crypto->getPublicKey(), other->getGroupQ(), other->getGroupP(), other->getGroupG(),
+                              msgCount, rangeProofCount, slotSize, msgPerBatch));
+    auto otherScheme = make_shared<PolynomialCommitment>(other->getGroupQ(), other->getGroupP(), other->getGroupG(), gi);
+    EXPECT_FALSE(key->matches(*otherScheme));
+    EXPECT_THROW(key->generateVerifier(proverCir->Cm, proverCir->Cm_, proverCir->CRj, ljir, Lj, otherScheme), invalid_argument);
+  }
+
+  // the static part is saved once and mapped back
+  key->save(path);
+  {
+    VerifierKey loaded(path);
+    EXPECT_TRUE(loaded.matches(crypto->getPublicKey(), GP_Q, GP_P, GP_G, msgCount, rangeProofCount, slotSize, msgPerBatch));
+    EXPECT_TRUE(check(loaded));
+  }
+
+  {
+    fstream fs(path, ios::in | ios::out | ios::binary);
+    fs.seekp(-1, ios::end);
+    fs.put(0x7f);
+  }
+  EXPECT_THROW(VerifierKey loaded(path), invalid_argument);
+
+  remove(path.c_str());
+}
+
+} // namespace
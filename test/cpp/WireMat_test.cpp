@@ -0,0 +1,113 @@
+#include "gtest/gtest.h"
+
+#include "app/namespace.hpp"
+
+#include "app/math/WireMat.hpp"
+#include "app/math/Matrix.hpp"
+
+namespace
+{
+
+TEST(WireMat, From_gates)
+{
+  auto p = conv<ZZ>(101);
+  ZZ_pPush push(p);
+
+  // 2 constrains over 6 gates, grouped to 3 x 2
+  auto w0 = make_shared<Matrix>(1, 6);
+  auto w1 = make_shared<Matrix>(1, 6);
+  w0->cell(0, 1, 1);
+  w0->cell(0, 4, -1);
+  w0->cell(0, 5, 0);
+  w1->cell(0, 0, 7);
+  w1->cell(0, 5, 3);
+
+  WireMat wire({w0, w1}, 3, 2);
+  EXPECT_EQ(wire.NumRows(), 3);
+  EXPECT_EQ(wire.NumCols(), 2);
+  EXPECT_EQ(wire.size(), 4);
+
+  auto row = wire.row(0);
+  ASSERT_EQ(row.size(), 2);
+  EXPECT_EQ(row.first[0].q, 0);
+  EXPECT_EQ(row.first[0].j, 1);
+  EXPECT_EQ(row.first[0].v, conv<ZZ_p>(1));
+  EXPECT_EQ(row.first[1].q, 1);
+  EXPECT_EQ(row.first[1].j, 0);
+  EXPECT_EQ(row.first[1].v, conv<ZZ_p>(7));
+
+  EXPECT_EQ(wire.row(1).size(), 0);
+
+  row = wire.row(2);
+  ASSERT_EQ(row.size(), 2);
+  EXPECT_EQ(row.first[0].q, 0);
+  EXPECT_EQ(row.first[0].j, 0);
+  EXPECT_EQ(row.first[0].v, conv<ZZ_p>(-1));
+  EXPECT_EQ(row.first[1].q, 1);
+  EXPECT_EQ(row.first[1].j, 1);
+
+  EXPECT_THROW(wire.row(3), invalid_argument);
+  EXPECT_THROW(WireMat({w0}, 2, 2), invalid_argument);
+}
+
+TEST(WireMat, From_rows)
+{
+  auto p = conv<ZZ>(101);
+  ZZ_pPush push(p);
+
+  auto w0 = make_shared<Matrix>(2, 3);
+  w0->cell(0, 2, 5);
+  w0->cell(1, 0, 1);
+  w0->cell(1, 1, 2);
+
+  // rows are built on up to 4 threads
+  WireMat wire({w0, w0}, 2, 3, 4);
+  EXPECT_EQ(wire.size(), 6);
+
+  size_t count = 0;
+  for (auto &e : wire.row(1))
+  {
+    EXPECT_EQ(e.q, count / 2);
+    EXPECT_EQ(e.j, count % 2);
+    EXPECT_EQ(e.v, conv<ZZ_p>((long)e.j + 1));
+    count++;
+  }
+  EXPECT_EQ(count, 4);
+}
+
+TEST(WireMat, From_cells)
+{
+  auto p = conv<ZZ>(101);
+  ZZ_pPush push(p);
+
+  // same entries as a gate vector, given in any order
+  vector<WireMat::Cell> cells;
+  cells.push_back({1, 5, conv<ZZ_p>(3)});
+  cells.push_back({0, 4, conv<ZZ_p>(-1)});
+  cells.push_back({0, 1, conv<ZZ_p>(1)});
+  cells.push_back({1, 0, conv<ZZ_p>(7)});
+  cells.push_back({1, 2, conv<ZZ_p>(0)});
+
+  WireMat wire(cells, 3, 2);
+  EXPECT_EQ(wire.size(), 4);
+  EXPECT_EQ(wire.row(1).size(), 0);
+
+  auto row = wire.row(2);
+  ASSERT_EQ(row.size(), 2);
+  EXPECT_EQ(row.first[0].q, 0);
+  EXPECT_EQ(row.first[0].j, 0);
+  EXPECT_EQ(row.first[1].q, 1);
+  EXPECT_EQ(row.first[1].j, 1);
+  EXPECT_EQ(row.first[1].v, conv<ZZ_p>(3));
+
+  // rebuilt from its arrays
+  WireMat copy(3, 2, wire.getOffsets(), wire.getEntries());
+  EXPECT_EQ(copy.size(), 4);
+  EXPECT_EQ(copy.row(0).first[1].v, conv<ZZ_p>(7));
+
+  cells.push_back({0, 6, conv<ZZ_p>(1)});
+  EXPECT_THROW(WireMat(cells, 3, 2), invalid_argument);
+  EXPECT_THROW(WireMat(2, 2, wire.getOffsets(), wire.getEntries()), invalid_argument);
+}
+
+} // namespace
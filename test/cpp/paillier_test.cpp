@@ -31,6 +31,33 @@ TEST(Paillier, KeyGeneration)
   EXPECT_EQ(GCD(c1->n, c1->lambda), 1);
 }
 
+TEST(Paillier, KeyGenerationParallel)
+{
+  // same keys for a fixed seed regardless of the thread count
+  vector<uint8_t> seed{0x00, 0x00, 0x00, 0x00, 0x00, 0x56, 0x78};
+  auto c1 = make_shared<PaillierEncryption>(32, seed, 1);
+  auto c2 = make_shared<PaillierEncryption>(32, seed, 4);
+  EXPECT_EQ(c1->p, c2->p);
+  EXPECT_EQ(c1->q, c2->q);
+  EXPECT_EQ(c1->Q, c2->Q);
+  EXPECT_EQ(c1->G, c2->G);
+  EXPECT_EQ(NumBytes(c1->getPublicKey()), 32);
+
+  // progress reports every stage
+  std::set<string> stages;
+  auto c3 = make_shared<PaillierEncryption>(16, seed, 2, [&](const string &stage, size_t count) {
+    stages.insert(stage);
+    return true;
+  });
+  EXPECT_EQ(stages, std::set<string>({"p", "q", "Q", "G"}));
+
+  // cancellation
+  EXPECT_THROW(make_shared<PaillierEncryption>(32, seed, 2, [](const string &stage, size_t count) {
+                 return stage != "Q";
+               }),
+               runtime_error);
+}
+
 TEST(Paillier, CyclicGroupGeneration)
 {
   // p = 3, q = 5, N = 15
@@ -60,6 +87,28 @@ TEST(Paillier, CyclicGroupGeneration)
   }
 }
 
+TEST(Paillier, GenerateGenerators)
+{
+  // p = 3, q = 5, N = 15
+  auto crypto = make_shared<PaillierEncryption>(ZZ(15), ZZ(3), ZZ(5));
+  auto seed = conv<ZZ>(1234);
+  auto n2 = crypto->n2;
+
+  auto g1 = crypto->genGenerators(20, seed, 1);
+  auto g2 = crypto->genGenerators(20, seed, 4);
+  EXPECT_EQ(g1, g2);
+  EXPECT_EQ(crypto->genGenerator(seed, 7), g1[7]);
+
+  ZZ_pPush push(crypto->Q);
+  for (long i = 0; i < g1.length(); i++)
+  {
+    // order is exactly n^2
+    EXPECT_EQ(power(g1[i], n2), 1);
+    EXPECT_NE(power(g1[i], n2 / 3), 1);
+    EXPECT_NE(power(g1[i], n2 / 5), 1);
+  }
+}
+
 TEST(Paillier, PickRandom)
 {
   size_t byteLength = 2;
@@ -96,6 +145,193 @@ TEST(Paillier, EncryptionDecryption)
   }
 }
 
+TEST(Paillier, DecryptionCRT)
+{
+  // p = 3, q = 5, N = 15
+  auto small = make_shared<PaillierEncryption>(ZZ(15), ZZ(3), ZZ(5));
+  for (long i = 0; i < 15; i++)
+  {
+    EXPECT_EQ(small->decrypt(small->encrypt(ZZ(i))), i);
+  }
+
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto N = crypto->getPublicKey();
+
+  // boundary messages
+  EXPECT_EQ(crypto->decrypt(crypto->encrypt(ZZ(0))), 0);
+  EXPECT_EQ(crypto->decrypt(crypto->encrypt(N - 1)), N - 1);
+
+  for (int i = 0; i < 50; i++)
+  {
+    auto m = RandomBnd(N);
+    EXPECT_EQ(crypto->decrypt(crypto->encrypt(m)), m);
+  }
+}
+
+TEST(Paillier, KeyHolderEncryption)
+{
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto encryptor = make_shared<PaillierEncryption>(crypto->getPublicKey(), crypto->getGroupQ(), crypto->n2, crypto->G);
+
+  EXPECT_TRUE(crypto->isKeyHolder());
+  EXPECT_FALSE(encryptor->isKeyHolder());
+
+  for (int i = 0; i < 20; i++)
+  {
+    auto m = RandomBits_ZZ(64);
+    auto r = crypto->pickRandom();
+
+    // CRT and public path give the same ciphertext
+    EXPECT_EQ(crypto->powerN(r), encryptor->powerN(r));
+    EXPECT_EQ(crypto->encrypt(m, r), encryptor->encrypt(m, r));
+  }
+}
+
+TEST(Paillier, DecryptBatch)
+{
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+
+  Vec<ZZ> ms;
+  Vec<ZZ_p> cs;
+  for (int i = 0; i < 40; i++)
+  {
+    auto m = RandomBits_ZZ(64);
+    ms.append(m);
+    cs.append(crypto->encrypt(m));
+  }
+
+  EXPECT_EQ(crypto->decryptBatch(cs), ms);
+  EXPECT_EQ(crypto->decryptBatch(cs, 1), ms);
+  EXPECT_EQ(crypto->decryptBatch(cs, 3), ms);
+  EXPECT_EQ(crypto->decryptBatch(Vec<ZZ_p>()).length(), 0);
+}
+
+TEST(Paillier, EncryptBatch)
+{
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+
+  Vec<ZZ> ms;
+  for (int i = 0; i < 40; i++)
+    ms.append(RandomBits_ZZ(64));
+
+  vector<uint8_t> seed{0x12, 0x34};
+  Vec<ZZ_p> c1, r1, c2, r2;
+  SetSeed(seed.data(), seed.size());
+  crypto->encryptBatch(ms, c1, r1, 1);
+  SetSeed(seed.data(), seed.size());
+  crypto->encryptBatch(ms, c2, r2, 4);
+
+  // same randomness regardless of the thread count
+  EXPECT_EQ(r1, r2);
+  EXPECT_EQ(c1, c2);
+  EXPECT_EQ(crypto->decryptBatch(c1), ms);
+  for (int i = 0; i < ms.length(); i++)
+    EXPECT_EQ(c1[i], crypto->encrypt(ms[i], r1[i]));
+}
+
+TEST(Paillier, RandomnessPool)
+{
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto GP_P = crypto->getGroupP();
+  auto GP_G = crypto->getGroupG();
+  auto encryptor = make_shared<PaillierEncryption>(crypto->getPublicKey(), crypto->getGroupQ(), GP_P, GP_G);
+
+  encryptor->attachPool(8, 2);
+  encryptor->pool->warmUp();
+  EXPECT_EQ(encryptor->pool->size(), 8);
+
+  for (int i = 0; i < 8; i++)
+  {
+    auto m = RandomBits_ZZ(64);
+    ZZ_p r, rn;
+    encryptor->pickRandom(r, rn);
+    EXPECT_EQ(rn, encryptor->powerN(r));
+
+    auto c = encryptor->encrypt(m, r, rn);
+    EXPECT_EQ(c, encryptor->encrypt(m, r));
+    EXPECT_EQ(crypto->decrypt(c), m);
+  }
+  EXPECT_EQ(encryptor->pool->getHits(), 8);
+  EXPECT_GE(encryptor->pool->getRefills(), 8);
+
+  // the randomness drawn from the pool is returned as the witness
+  encryptor->pool->warmUp();
+  for (int i = 0; i < 4; i++)
+  {
+    auto m = RandomBits_ZZ(64);
+    ZZ_p r;
+    auto c = encryptor->encrypt(m, &r);
+    EXPECT_EQ(encryptor->pool->getHits(), 9 + i);
+    EXPECT_EQ(crypto->decrypt(c), m);
+    EXPECT_EQ(c, crypto->encrypt(m, r));
+  }
+
+  // no background refill, an empty pool falls back to the online path
+  encryptor->attachPool(2, 0);
+  ZZ_p r, rn;
+  encryptor->pickRandom(r, rn);
+  EXPECT_EQ(encryptor->pool->getMisses(), 1);
+  EXPECT_EQ(rn, encryptor->powerN(r));
+
+  encryptor->pool->warmUp();
+  auto m = conv<ZZ>(123);
+  EXPECT_EQ(crypto->decrypt(encryptor->encrypt(m)), m);
+  EXPECT_EQ(encryptor->pool->getHits(), 1);
+
+  encryptor->detachPool();
+  EXPECT_EQ(encryptor->pool, nullptr);
+
+  // all workers failed, warmUp reports the failure instead of waiting
+  RandomnessPool failing([](ZZ_p &r, ZZ_p &rx) { throw runtime_error("no randomness"); }, 4, 2);
+  EXPECT_THROW(failing.warmUp(), runtime_error);
+  EXPECT_EQ(failing.size(), 0);
+}
+
+TEST(Paillier, ShortExponent)
+{
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto GP_P = crypto->getGroupP();
+  auto GP_G = crypto->getGroupG();
+  auto encryptor = make_shared<PaillierEncryption>(crypto->getPublicKey(), crypto->getGroupQ(), GP_P, GP_G);
+
+  // too short to hide the exponent
+  EXPECT_THROW(encryptor->enableShortExponent(1), invalid_argument);
+  EXPECT_THROW(encryptor->enableShortExponent(PaillierEncryption::MIN_SHORT_EXPONENT_BITS - 1), invalid_argument);
+
+  encryptor->enableShortExponent(PaillierEncryption::MIN_SHORT_EXPONENT_BITS);
+  for (int i = 0; i < 20; i++)
+  {
+    auto m = RandomBits_ZZ(64);
+    ZZ_p r, rn;
+    encryptor->pickRandom(r, rn);
+
+    // r is an ordinary element mod n
+    EXPECT_TRUE(r != 0);
+    EXPECT_EQ(GCD(rep(r), encryptor->n), 1);
+    EXPECT_EQ(rn, encryptor->powerN(r));
+
+    auto c = encryptor->encrypt(m, r, rn);
+    EXPECT_EQ(c, crypto->encrypt(m, r));
+    EXPECT_EQ(crypto->decrypt(c), m);
+  }
+
+  // with the randomness pool
+  encryptor->attachPool(4, 1);
+  encryptor->pool->warmUp();
+  auto m = conv<ZZ>(123);
+  EXPECT_EQ(crypto->decrypt(encryptor->encrypt(m)), m);
+
+  encryptor->disableShortExponent();
+  EXPECT_EQ(crypto->decrypt(encryptor->encrypt(m)), m);
+  encryptor->detachPool();
+}
+
 TEST(Paillier, EncryptionDecryption2)
 {
   size_t byteLength = 32;
@@ -201,6 +437,38 @@ TEST(Paillier, HomomorphicMultiplication)
   }
 }
 
+TEST(Paillier, LinearCombination)
+{
+  size_t byteLength = 32;
+  auto crypto = make_shared<PaillierEncryption>(byteLength);
+  auto N = crypto->getPublicKey();
+
+  Vec<ZZ_p> cs;
+  Vec<ZZ> ws;
+  ZZ sum;
+  for (int i = 0; i < 30; i++)
+  {
+    auto m = RandomBits_ZZ(32);
+    auto w = RandomBits_ZZ(32);
+    if (i % 5 == 0)
+      w = -w;
+    cs.append(crypto->encrypt(m));
+    ws.append(w);
+    sum += m * w;
+  }
+
+  EXPECT_EQ(crypto->decrypt(crypto->linearCombination(cs, ws)), sum % N);
+  EXPECT_EQ(crypto->decrypt(crypto->linearCombination(cs, ws, 1)), sum % N);
+
+  // plaintext addition keeps the randomness
+  auto m1 = conv<ZZ>(30);
+  auto m2 = conv<ZZ>(12);
+  auto r = crypto->pickRandom();
+  auto c = crypto->addPlain(crypto->encrypt(m1, r), m2);
+  EXPECT_EQ(c, crypto->encrypt(m1 + m2, r));
+  EXPECT_EQ(crypto->decrypt(c), m1 + m2);
+}
+
 TEST(Paillier, Generate_group_element)
 {
   size_t byteLength = 2;